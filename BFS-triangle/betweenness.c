@@ -0,0 +1,89 @@
+/*
+Info:
+Feel free to use these lines as you wish. This program computes the betweenness centrality of every node, exactly or approximately by sampling shortest paths. The graph is assumed to be undirected.
+
+To compile:
+"gcc betweenness.c -O3 -o betweenness -I../graph ../graph/libgraph.a -fopenmp -lz -lbz2 -lm" (after "make" in ../graph).
+
+To execute:
+"./betweenness edgelist.txt output.txt [eps=e] [delta=d] [seed=s]".
+"edgelist.txt" should contain the graph: one edge on each line (two unsigned long (nodes' ID)) separated by a space.
+"output.txt" will contain the betweenness values: "nodeID betweenness" on each line. The value of v is the sum over the pairs {s,t} of the
+fraction of the shortest paths from s to t going through v (divide it by (n-1)(n-2)/2 to normalize it).
+Without "eps", the exact values are computed (algorithm of Brandes, one BFS and one back-propagation from every node, on all the cores).
+With "eps=e", the values are estimated from a sample of shortest paths (Riondato and Kornaropoulos): divided by (n-1)n/2, they are all
+within e of the exact normalized values with probability at least 1-d ("delta=d", 0.1 by default). The number of samples grows as 1/e^2.
+"seed=s" fixes the seed of the sampling (the current time by default): the same seed gives the same values whatever the number of threads.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>//to estimate the runing time
+
+#include "graph.h"
+
+#define DELTA 0.1
+
+int main(int argc,char** argv){
+	adjlist* g;
+	double *bc,eps=0,delta=DELTA;
+	unsigned long r;
+	unsigned seed=time(NULL);
+	int i;
+
+	time_t t1,t2;
+
+	if (argc<3) {
+		fprintf(stderr,"Usage: %s edgelist.txt output.txt [eps=e] [delta=d] [seed=s]\n",argv[0]);
+		return 1;
+	}
+	for (i=3;i<argc;i++) {
+		if (strncmp(argv[i],"eps=",4)==0)
+			eps=atof(argv[i]+4);
+		else if (strncmp(argv[i],"delta=",6)==0)
+			delta=atof(argv[i]+6);
+		else if (strncmp(argv[i],"seed=",5)==0)
+			seed=strtoul(argv[i]+5,NULL,10);
+		else {
+			fprintf(stderr,"Unknown option %s\n",argv[i]);
+			return 1;
+		}
+	}
+	if (eps<0 || eps>=1 || delta<=0 || delta>=1) {
+		fprintf(stderr,"eps and delta should be in (0,1)\n");
+		return 1;
+	}
+
+	t1=time(NULL);
+
+	printf("Reading graph from file %s\n",argv[1]);
+
+	g=loadadjlist(argv[1],0);
+
+	printf("Number of nodes: %lu\n",g->n);
+	printf("Number of edges: %lu\n",g->e);
+
+	bc=malloc(g->n*sizeof(double));
+	if (eps==0) {
+		printf("Computing the exact betweenness\n");
+		betweenness(g,bc);
+	}
+	else {
+		printf("Estimating the betweenness with eps=%g and delta=%g\n",eps,delta);
+		r=betweenness_rk(g,eps,delta,seed,bc);
+		printf("Number of sampled shortest paths: %lu\n",r);
+	}
+
+	printf("Writting to file %s\n",argv[2]);
+	writevalues(g,bc,VAL_F64,argv[2]);
+
+	free_adjlist(g);
+	free(bc);
+
+	t2=time(NULL);
+
+	printf("- Overall time = %ldh%ldm%lds\n",(t2-t1)/3600,((t2-t1)%3600)/60,((t2-t1)%60));
+
+	return 0;
+}
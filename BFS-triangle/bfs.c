@@ -8,16 +8,17 @@ Info:
 Feel free to use these lines as you wish. This program computes shortest paths using BFS. The graph is assumed to be undirected.
 
 To compile:
-"gcc bfs.c -O9 -o bfs".
+"gcc bfs.c -O9 -o bfs -I../graph ../graph/libgraph.a -fopenmp -lz -lbz2" (after "make" in ../graph).
 
 To execute:
 "./bfs edgelist.txt n1 n2 n3 ... n_k".
 "edgelist.txt" should contain the graph: one edge on each line (two unsigned long (nodes' ID)) separated by a space.
 It computes the shotest path from node n1 to all nodes in the graph and writes the result in a file called "n1". It the does the same for n2, n3,... and n_k
+The size, number of edges scanned and direction (top-down or bottom-up, see ../graph/bfs.c) of every level are printed in the terminal.
 
 Note:
-If the graph is directed (and weighted) with selfloops and you want to make it undirected unweighted without selfloops, use the following linux command line.
-awk '{if ($1<$2) print $1" "$2;else if ($2<$1) print $2" "$1}' net.txt | sort -n -k1,2 -u > net2.txt
+If the graph is directed (and weighted) with selfloops and you want to make it undirected unweighted without selfloops, use the canonicalizer of the root directory (parallel, and it also works on files larger than the memory).
+../canon.exe net.txt net2.txt
 
 Performance:
 Up to 500 million edges on my laptop with 8G of RAM:
@@ -28,157 +29,40 @@ Takes more or less 1.6G of RAM and 25 seconds (I have an SSD hardrive) for 100M
 #include <stdio.h>
 #include <time.h>//to estimate the runing time
 
-#define NLINKS 100000000 //maximum number of edges for memory allocation, will increase if needed
-
-typedef struct {
-	unsigned long s;
-	unsigned long t;
-} edge;
-
-//edge list structure:
-typedef struct {
-	unsigned long n;//number of nodes
-	unsigned long e;//number of edges
-	edge *edges;//list of edges
-	unsigned long *cd;//cumulative degree cd[0]=0 length=n+1
-	unsigned long *adj;//concatenated lists of neighbors of all nodes
-} adjlist;
-
-//compute the maximum of three unsigned long
-inline unsigned long max3(unsigned long a,unsigned long b,unsigned long c){
-	a=(a>b) ? a : b;
-	return (a>c) ? a : c;
-}
-
-//reading the edgelist from file
-adjlist* readedgelist(char* input){
-	unsigned long e1=NLINKS;
-	adjlist *g=malloc(sizeof(adjlist));
-	FILE *file;
-
-	g->n=0;
-	g->e=0;
-	file=fopen(input,"r");
-	g->edges=malloc(e1*sizeof(edge));
-	while (fscanf(file,"%lu %lu", &(g->edges[g->e].s), &(g->edges[g->e].t))==2) {
-		g->n=max3(g->n,g->edges[g->e].s,g->edges[g->e].t);
-		if (g->e++==e1) {
-			e1+=NLINKS;
-			g->edges=realloc(g->edges,e1*sizeof(edge));
-		}
-	}
-	fclose(file);
-	g->n++;
-
-	g->edges=realloc(g->edges,g->e*sizeof(edge));
-
-	return g;
-}
-
-//building the adjacency list
-void mkadjlist(adjlist* g){
-	unsigned long i,u,v;
-	unsigned long *d=calloc(g->n,sizeof(unsigned long));
-
-	for (i=0;i<g->e;i++) {
-		d[g->edges[i].s]++;
-		d[g->edges[i].t]++;
-	}
-
-	g->cd=malloc((g->n+1)*sizeof(unsigned long));
-	g->cd[0]=0;
-	for (i=1;i<g->n+1;i++) {
-		g->cd[i]=g->cd[i-1]+d[i-1];
-		d[i-1]=0;
-	}
-
-	g->adj=malloc(2*g->e*sizeof(unsigned long));
-
-	for (i=0;i<g->e;i++) {
-		u=g->edges[i].s;
-		v=g->edges[i].t;
-		g->adj[ g->cd[u] + d[u]++ ]=v;
-		g->adj[ g->cd[v] + d[v]++ ]=u;
-	}
-
-	free(d);
-	free(g->edges);
-}
-
-//freeing memory
-void free_adjlist(adjlist *g){
-	//free(g->edges);
-	free(g->cd);
-	free(g->adj);
-	free(g);
-}
-
-
-unsigned *bfs(adjlist *g,unsigned long u) {
-	unsigned long n=g->n,l=1,i,j,v;
-
-	static unsigned *dist=NULL,*list=NULL;
-
-	if (dist==NULL){
-		dist=malloc(n*sizeof(unsigned));
-		list=malloc(n*sizeof(unsigned));//this will not be freed
-	}
-
-	for (i=0;i<n;i++) {
-		dist[i]=-1;
-	}
-
-	list[0]=u;
-	
-	dist[u]=0;
-
-	for (i=0;i<l;i++) {
-		v=list[i];
-		for (j=g->cd[v];j<g->cd[v+1];j++) {
-			if (dist[g->adj[j]]==-1) {
-				list[l++]=g->adj[j];
-				dist[g->adj[j]]=dist[v]+1;
-			}
-		}
-	}
-
-	return dist;
-
-}
-
+#include "graph.h"
 
 int main(int argc,char** argv){
 	adjlist* g;
 	unsigned *dist;
-	unsigned i;
-	unsigned long j,u;
-	FILE* file;
+	unsigned i,k,nl;
+	unsigned long u;
+	const bfslevel *levels;
 
 	time_t t1,t2;
 
 	t1=time(NULL);
 
-	printf("Reading edgelist from file %s\n",argv[1]);
-	g=readedgelist(argv[1]);
+	printf("Reading graph from file %s\n",argv[1]);
+	g=loadadjlist(argv[1],0);
 
 	printf("Number of nodes: %lu\n",g->n);
 	printf("Number of edges: %lu\n",g->e);
 
-	printf("Building the adjacency list\n");
-	mkadjlist(g);
-
 	for (i=2;i<argc;i++) {
 		
-		u=atoi(argv[i]);
-		printf("Computing distances from node %lu\n",u);
+		u=findnode(g,strtoul(argv[i],NULL,10));
+		if (u==NONODE) {
+			printf("Node %s is not in the graph\n",argv[i]);
+			continue;
+		}
+		printf("Computing distances from node %s\n",argv[i]);
 		dist=bfs(g,u);
+		nl=bfs_levels(&levels);
+		for (k=0;k<nl;k++)
+			printf("level %u: %lu nodes, %lu edges scanned, %s\n",k,levels[k].nodes,levels[k].edges,levels[k].bottomup ? "bottom-up" : "top-down");
 
 		printf("Writting to file\n");
-		file=fopen(argv[i],"w");
-		for (j=0;j<g->n;j++) {
-			fprintf(file,"%lu %u\n",j,dist[j]);
-		}
-		fclose(file);
+		writevalues(g,dist,VAL_U32,argv[i]);
 	}
 
 
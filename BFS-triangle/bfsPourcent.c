@@ -5,19 +5,20 @@ http://bit.ly/danisch
 maximilien.danisch@gmail.com
 
 Info:
-Feel free to use these lines as you wish. This program computes shortest paths using BFS. The graph is assumed to be undirected.
+Feel free to use these lines as you wish. This program computes the fraction of the nodes in the largest connected component. The graph is assumed to be undirected.
+The components are computed on all the cores with a parallel union-find (see ../graph/cc.c), in near-linear time even on fragmented graphs.
 
 To compile:
-"gcc bfs.c -O9 -o bfs".
+"gcc bfsPourcent.c -O9 -o bfsPourcent -I../graph ../graph/libgraph.a -fopenmp -lz -lbz2" (after "make" in ../graph).
 
 To execute:
-"./bfs edgelist.txt n1 n2 n3 ... n_k".
+"./bfsPourcent edgelist.txt".
 "edgelist.txt" should contain the graph: one edge on each line (two unsigned long (nodes' ID)) separated by a space.
-It computes the shotest path from node n1 to all nodes in the graph and writes the result in a file called "n1". It the does the same for n2, n3,... and n_k
+The percentage of the nodes in the largest connected component is printed in the terminal (see ./components for all the components).
 
 Note:
-If the graph is directed (and weighted) with selfloops and you want to make it undirected unweighted without selfloops, use the following linux command line.
-awk '{if ($1<$2) print $1" "$2;else if ($2<$1) print $2" "$1}' net.txt | sort -n -k1,2 -u > net2.txt
+If the graph is directed (and weighted) with selfloops and you want to make it undirected unweighted without selfloops, use the canonicalizer of the root directory (parallel, and it also works on files larger than the memory).
+../canon.exe net.txt net2.txt
 
 Performance:
 Up to 500 million edges on my laptop with 8G of RAM:
@@ -28,164 +29,36 @@ Takes more or less 1.6G of RAM and 25 seconds (I have an SSD hardrive) for 100M
 #include <stdio.h>
 #include <time.h>//to estimate the runing time
 
-#define NLINKS 100000000 //maximum number of edges for memory allocation, will increase if needed
-
-typedef struct {
-	unsigned long s;
-	unsigned long t;
-} edge;
-
-//edge list structure:
-typedef struct {
-	unsigned long n;//number of nodes
-	unsigned long e;//number of edges
-	edge *edges;//list of edges
-	unsigned long *cd;//cumulative degree cd[0]=0 length=n+1
-	unsigned long *adj;//concatenated lists of neighbors of all nodes
-} adjlist;
-
-//compute the maximum of three unsigned long
-inline unsigned long max3(unsigned long a,unsigned long b,unsigned long c){
-	a=(a>b) ? a : b;
-	return (a>c) ? a : c;
-}
-
-//reading the edgelist from file
-adjlist* readedgelist(char* input){
-	unsigned long e1=NLINKS;
-	adjlist *g=malloc(sizeof(adjlist));
-	FILE *file;
-
-	g->n=0;
-	g->e=0;
-	file=fopen(input,"r");
-	g->edges=malloc(e1*sizeof(edge));
-	while (fscanf(file,"%lu %lu", &(g->edges[g->e].s), &(g->edges[g->e].t))==2) {
-		g->n=max3(g->n,g->edges[g->e].s,g->edges[g->e].t);
-		if (g->e++==e1) {
-			e1+=NLINKS;
-			g->edges=realloc(g->edges,e1*sizeof(edge));
-		}
-	}
-	fclose(file);
-	g->n++;
-
-	g->edges=realloc(g->edges,g->e*sizeof(edge));
-
-	return g;
-}
-
-//building the adjacency list
-void mkadjlist(adjlist* g){
-	unsigned long i,u,v;
-	unsigned long *d=calloc(g->n,sizeof(unsigned long));
-
-	for (i=0;i<g->e;i++) {
-		d[g->edges[i].s]++;
-		d[g->edges[i].t]++;
-	}
-
-	g->cd=malloc((g->n+1)*sizeof(unsigned long));
-	g->cd[0]=0;
-	for (i=1;i<g->n+1;i++) {
-		g->cd[i]=g->cd[i-1]+d[i-1];
-		d[i-1]=0;
-	}
-
-	g->adj=malloc(2*g->e*sizeof(unsigned long));
-
-	for (i=0;i<g->e;i++) {
-		u=g->edges[i].s;
-		v=g->edges[i].t;
-		g->adj[ g->cd[u] + d[u]++ ]=v;
-		g->adj[ g->cd[v] + d[v]++ ]=u;
-	}
-
-	free(d);
-	free(g->edges);
-}
-
-//freeing memory
-void free_adjlist(adjlist *g){
-	//free(g->edges);
-	free(g->cd);
-	free(g->adj);
-	free(g);
-}
-
-
-unsigned *bfs(adjlist *g,unsigned long u) {
-	unsigned long n=g->n,l=1,i,j,v;
-
-	static unsigned *dist=NULL,*list=NULL;
-
-	if (dist==NULL){
-		dist=malloc(n*sizeof(unsigned));
-		list=malloc(n*sizeof(unsigned));//this will not be freed
-	}
-
-	for (i=0;i<n;i++) {
-		dist[i]=-1;
-	}
-
-	list[0]=u;
-	
-	dist[u]=0;
-
-	for (i=0;i<l;i++) {
-		v=list[i];
-		for (j=g->cd[v];j<g->cd[v+1];j++) {
-			if (dist[g->adj[j]]==-1) {
-				list[l++]=g->adj[j];
-				dist[g->adj[j]]=dist[v]+1;
-			}
-		}
-	}
-
-	return dist;
-
-}
+#include "graph.h"
 
 int main(int argc,char** argv){
 	adjlist* g;
-	unsigned *dist;
-	unsigned i;
-	unsigned long j,u;
-	FILE* file;
+	node_t *comp;
+	unsigned long j,maxs=0,*size;
 
 	time_t t1,t2;
 
 	t1=time(NULL);
 
-	printf("Reading edgelist from file %s\n",argv[1]);
-	g=readedgelist(argv[1]);
+	printf("Reading graph from file %s\n",argv[1]);
+	g=loadadjlist(argv[1],0);
 
 	printf("Number of nodes: %lu\n",g->n);
 	printf("Number of edges: %lu\n",g->e);
-
-	printf("Building the adjacency list\n");
-	mkadjlist(g);
 	
-	float maxP = -1.;
-
-	for (i=0;i<g->n;i++) {
-		
-		u=i;
-		dist=bfs(g,u);
-		
-		int cpt = 0;
+	//all the components at once (../graph/cc.c), size of each one indexed by its smallest node
+	comp=malloc(g->n*sizeof(node_t));
+	size=calloc(g->n,sizeof(unsigned long));
+	connected_components(g,comp);
+	for (j=0;j<g->n;j++)
+		size[comp[j]]++;
+	for (j=0;j<g->n;j++)
+		if (size[j]>maxs)
+			maxs=size[j];
+	float maxP = (g->n>0) ? (100.0*maxs)/g->n : 0.;
+	free(size);
+	free(comp);
 
-		for (j=0;j<g->n;j++) {
-			if(dist[j] == -1) {
-				cpt++;
-			}
-		}
-		float tmpP = (1 - ((1.0*cpt)/(1.0*g->n)))*100;
-		maxP = tmpP > maxP ? tmpP : maxP;
-		if(maxP > 50.0) {
-			break;
-		}
-	}
 	printf("Largest connected component (fraction of nodes) = %f\n", maxP);	
 
 
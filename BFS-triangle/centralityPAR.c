@@ -8,7 +8,7 @@ Info:
 Feel free to use these lines as you wish. This program computes an approximation of the closeness centrality such as described in https://papers-gamma.link/paper/35. The graph is assumed to be undirected.
 
 To compile:
-"gcc centralityPAR.c -O3 -o centralityPAR -fopenmp".
+"gcc centralityPAR.c -O3 -o centralityPAR -I../graph ../graph/libgraph.a -fopenmp -lz -lbz2" (after "make" in ../graph).
 
 To execute:
 "./centralityPAR p k edgelist.txt output.txt".  
@@ -16,6 +16,10 @@ To execute:
 "k" is the number of nodes to consider to compute the approximation of the diameter such as described in [2].  
 "edgelist.txt" should contain the graph: one edge on each line (two unsigned long (nodes' ID)) separated by a space.  
 "output.txt" will contain the closeness centrality values: "nodeID closeness_centrality_approximation" on each line.  
+
+Every thread runs its BFS in its own workspace (bfs_ctx, see ../graph/bfs.c) and only visits the nodes reached from its reference node:
+nothing of size n is reset between two searches. The reference nodes are drawn before the parallel loop (rand is not thread-safe).
+The threads sum the distances in their own arrays, which are then added node by node in parallel.
 */
 
 #include <stdlib.h>
@@ -24,133 +28,17 @@ To execute:
 #include <time.h>//to estimate the runing time
 #include <omp.h>
 
-#define NLINKS 100000000 //maximum number of edges for memory allocation, will increase if needed
-
-typedef struct {
-	unsigned long s;
-	unsigned long t;
-} edge;
-
-//edge list structure:
-typedef struct {
-	unsigned long n;//number of nodes
-	unsigned long e;//number of edges
-	edge *edges;//list of edges
-	unsigned long *cd;//cumulative degree cd[0]=0 length=n+1
-	unsigned long *adj;//concatenated lists of neighbors of all nodes
-} adjlist;
-
-//compute the maximum of three unsigned long
-inline unsigned long max3(unsigned long a,unsigned long b,unsigned long c){
-	a=(a>b) ? a : b;
-	return (a>c) ? a : c;
-}
-
-//reading the edgelist from file
-adjlist* readedgelist(char* input){
-	unsigned long e1=NLINKS;
-	adjlist *g=malloc(sizeof(adjlist));
-	FILE *file;
-
-	g->n=0;
-	g->e=0;
-	file=fopen(input,"r");
-	g->edges=malloc(e1*sizeof(edge));
-	while (fscanf(file,"%lu %lu", &(g->edges[g->e].s), &(g->edges[g->e].t))==2) {
-		g->n=max3(g->n,g->edges[g->e].s,g->edges[g->e].t);
-		if (g->e++==e1) {
-			e1+=NLINKS;
-			g->edges=realloc(g->edges,e1*sizeof(edge));
-		}
-	}
-	fclose(file);
-	g->n++;
-
-	g->edges=realloc(g->edges,g->e*sizeof(edge));
-
-	return g;
-}
-
-//building the adjacency list
-void mkadjlist(adjlist* g){
-	unsigned long i,u,v;
-	unsigned long *d=calloc(g->n,sizeof(unsigned long));
-
-	for (i=0;i<g->e;i++) {
-		d[g->edges[i].s]++;
-		d[g->edges[i].t]++;
-	}
-
-	g->cd=malloc((g->n+1)*sizeof(unsigned long));
-	g->cd[0]=0;
-	for (i=1;i<g->n+1;i++) {
-		g->cd[i]=g->cd[i-1]+d[i-1];
-		d[i-1]=0;
-	}
-
-	g->adj=malloc(2*g->e*sizeof(unsigned long));
-
-	for (i=0;i<g->e;i++) {
-		u=g->edges[i].s;
-		v=g->edges[i].t;
-		g->adj[ g->cd[u] + d[u]++ ]=v;
-		g->adj[ g->cd[v] + d[v]++ ]=u;
-	}
-
-	free(d);
-	free(g->edges);
-}
-
-//freeing memory
-void free_adjlist(adjlist *g){
-	//free(g->edges);
-	free(g->cd);
-	free(g->adj);
-	free(g);
-}
-
-
-unsigned *bfs(adjlist *g,unsigned long u) {
-	unsigned long n=g->n,l=1,i,j,v;
-
-	static unsigned *dist=NULL,*list=NULL;
-
-	if (dist==NULL){
-		dist=malloc(n*sizeof(unsigned));
-		list=malloc(n*sizeof(unsigned));//this will not be freed
-	}
-
-	for (i=0;i<n;i++) {
-		dist[i]=-1;
-	}
-
-	list[0]=u;
-	
-	dist[u]=0;
-
-	for (i=0;i<l;i++) {
-		v=list[i];
-		for (j=g->cd[v];j<g->cd[v+1];j++) {
-			if (dist[g->adj[j]]==-1) {
-				list[l++]=g->adj[j];
-				dist[g->adj[j]]=dist[v]+1;
-			}
-		}
-	}
-
-	return dist;
-
-}
-
+#include "graph.h"
 
 int main(int argc,char** argv){
 	adjlist* g;
-	unsigned *dist,*sumdist,*sumdist_p;
+	unsigned long *sumdist,*src,**sumdist_t;
+	unsigned *reach,**reach_t;
 	unsigned i,k;
-	double r;
-	unsigned long j,u;
-	bool *tab,*tab_p;
-	FILE* file;
+	int nt,t;
+	double r,*c;
+	unsigned long j;
+	bool *tab;
 
 	time_t t1,t2;
 
@@ -163,71 +51,81 @@ int main(int argc,char** argv){
 	printf("Number of reference nodes to consider %s\n",argv[2]);
 	k=atoi(argv[2]);
 
-	printf("Reading edgelist from file %s\n",argv[3]);
+	printf("Reading graph from file %s\n",argv[3]);
 
-	g=readedgelist(argv[3]);
+	g=loadadjlist(argv[3],0);
 
 	printf("Number of nodes: %lu\n",g->n);
 	printf("Number of edges: %lu\n",g->e);
 
-	printf("Building the adjacency list\n");
-	mkadjlist(g);
-
 	srand(time(NULL));//initialisation of rand
 
 	sumdist=calloc(g->n,sizeof(unsigned long));
+	reach=calloc(g->n,sizeof(unsigned));//number of reference nodes reaching each node
 	tab=calloc(g->n,sizeof(bool));
+	src=malloc(k*sizeof(unsigned long));
+	for (i=0;i<k;i++)
+		src[i]=rand() % g->n;
 
-	#pragma omp parallel private(i,j,u,dist,sumdist_p,tab_p)
+	nt=omp_get_max_threads();
+	sumdist_t=calloc(nt,sizeof(unsigned long*));
+	reach_t=calloc(nt,sizeof(unsigned*));
+
+	#pragma omp parallel private(i,j)
 	{
-	sumdist_p=calloc(g->n,sizeof(unsigned long));
-	tab_p=calloc(g->n,sizeof(bool));
+	bfsctx *c=mkbfsctx(g);
+	unsigned long *sumdist_p=calloc(g->n,sizeof(unsigned long));
+	unsigned *reach_p=calloc(g->n,sizeof(unsigned));
+
+	sumdist_t[omp_get_thread_num()]=sumdist_p;
+	reach_t[omp_get_thread_num()]=reach_p;
 
-	#pragma omp for schedule(dynamic) nowait
+	#pragma omp for schedule(dynamic)
 	for (i=0;i<k;i++) {
-		
-		u=rand() % g->n;
-		//printf("Computing distances from node %lu\n",u);
+		//printf("Computing distances from node %lu\n",src[i]);
 
-		dist=bfs(g,u);
+		bfs_ctx(g,c,src[i]);
 
-		for (j=0;j<g->n;j++){
-			if (dist[j]==-1)
-				tab_p[j]=1;
-			else
-				sumdist_p[j]+=dist[j];
+		for (j=0;j<c->len;j++){
+			node_t v=c->queue[j];
+			sumdist_p[v]+=c->dist[v];
+			reach_p[v]++;
 		}
 	}
 
-	free(dist);
-
-	#pragma omp critical
-	{
-		for (j=0;j<g->n;j++){
-			if (tab_p[j]==1)
-				tab[j]=1;
-			else
-				sumdist[j]+=sumdist_p[j];
-		}
-		free(sumdist_p);
-		free(tab_p);
+	free_bfsctx(c);
 	}
+
+	//sum of the arrays of the threads
+	#pragma omp parallel for private(t)
+	for (j=0;j<g->n;j++)
+		for (t=0;t<nt;t++)
+			if (sumdist_t[t]!=NULL) {
+				sumdist[j]+=sumdist_t[t][j];
+				reach[j]+=reach_t[t][j];
+			}
+	for (t=0;t<nt;t++) {
+		free(sumdist_t[t]);
+		free(reach_t[t]);
 	}
+	free(sumdist_t);
+	free(reach_t);
 
+	for (j=0;j<g->n;j++)
+		tab[j]=(reach[j]<k);
 
 	printf("Writting to file %s\n",argv[4]);
-	file=fopen(argv[4],"w");
 	r=((double)(k*(g->n-1)))/((double)(g->n));
-	for (j=0;j<g->n;j++) {
-		if (tab[j])
-			fprintf(file,"%lu %le\n",j,0.);
-		else
-			fprintf(file,"%lu %le\n",j,r/((double)sumdist[j]));
-	}
-	fclose(file);
+	c=malloc(g->n*sizeof(double));
+	for (j=0;j<g->n;j++)
+		c[j]=tab[j] ? 0. : r/((double)sumdist[j]);
+	writevalues(g,c,VAL_F64,argv[4]);
+	free(c);
 
 	free_adjlist(g);
 	free(tab);
+	free(reach);
+	free(src);
 	free(sumdist);
 
 	t2=time(NULL);
@@ -0,0 +1,97 @@
+/*
+Info:
+Feel free to use these lines as you wish. This program computes the exact closeness (or harmonic) centrality of every node, or only the k nodes of largest centrality. The graph is assumed to be undirected.
+
+To compile:
+"gcc closeness.c -O3 -o closeness -I../graph ../graph/libgraph.a -fopenmp -lz -lbz2" (after "make" in ../graph).
+
+To execute:
+"./closeness edgelist.txt output.txt [harmonic] [top=k]".
+"edgelist.txt" should contain the graph: one edge on each line (two unsigned long (nodes' ID)) separated by a space.
+"output.txt" will contain the centrality values: "nodeID value" on each line.
+With "harmonic", the harmonic centrality (sum of the inverses of the distances divided by n-1) is computed instead of the closeness.
+With "top=k", only the k nodes of largest centrality are computed and written by decreasing value.
+The closeness of a node v is (r-1)^2/((n-1)*f) where r is the size of the component of v and f the sum of the distances from v to its nodes:
+it is (n-1)/f on a connected graph and is not broken on disconnected graphs (see ../graph/closeness.c).
+
+How it works:
+Without "top=k", one BFS from every node, on all the cores (every thread has its own BFS workspace).
+With "top=k", the BFS from a node stops as soon as a bound shows that it cannot be among the k best ones (Bergamini et al., ALENEX 2016).
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>//to estimate the runing time
+
+#include "graph.h"
+
+int main(int argc,char** argv){
+	adjlist* g;
+	double *c;
+	node_t *top;
+	unsigned long j,k=0,edges;
+	int harmonic=0,i;
+	FILE* file;
+
+	time_t t1,t2;
+
+	if (argc<3) {
+		fprintf(stderr,"Usage: %s edgelist.txt output.txt [harmonic] [top=k]\n",argv[0]);
+		return 1;
+	}
+	for (i=3;i<argc;i++) {
+		if (strcmp(argv[i],"harmonic")==0)
+			harmonic=1;
+		else if (strncmp(argv[i],"top=",4)==0)
+			k=strtoul(argv[i]+4,NULL,10);
+		else {
+			fprintf(stderr,"Unknown option %s\n",argv[i]);
+			return 1;
+		}
+	}
+
+	t1=time(NULL);
+
+	printf("Reading graph from file %s\n",argv[1]);
+
+	g=loadadjlist(argv[1],0);
+
+	printf("Number of nodes: %lu\n",g->n);
+	printf("Number of edges: %lu\n",g->e);
+
+	if (k>g->n)
+		k=g->n;
+	if (k==0) {
+		printf("Computing the %s centrality of all nodes\n",harmonic?"harmonic":"closeness");
+		c=malloc(g->n*sizeof(double));
+		closeness(g,harmonic,c);
+	}
+	else {
+		printf("Computing the %lu nodes of largest %s centrality\n",k,harmonic?"harmonic":"closeness");
+		c=malloc(k*sizeof(double));
+		top=malloc(k*sizeof(node_t));
+		edges=closeness_topk(g,harmonic,k,top,c);
+		printf("Edges scanned: %lu (%.2f times the number of edge entries)\n",edges,(g->cd[g->n]>0)?(double)edges/g->cd[g->n]:0.);
+	}
+
+	printf("Writting to file %s\n",argv[2]);
+	if (k==0)
+		writevalues(g,c,VAL_F64,argv[2]);
+	else {
+		file=fopen(argv[2],"w");
+		for (j=0;j<k;j++)
+			fprintf(file,"%lu %le\n",(unsigned long)nodeid(g,top[j]),c[j]);
+		fclose(file);
+		free(top);
+	}
+
+	free_adjlist(g);
+	free(c);
+
+	t2=time(NULL);
+
+	printf("- Overall time = %ldh%ldm%lds\n",(t2-t1)/3600,((t2-t1)%3600)/60,((t2-t1)%60));
+
+	return 0;
+}
@@ -0,0 +1,92 @@
+/*
+Info:
+Feel free to use these lines as you wish. This program computes the connected components of the graph on all the cores (see ../graph/cc.c). The graph is assumed to be undirected.
+
+To compile:
+"gcc components.c -O3 -o components -I../graph ../graph/libgraph.a -fopenmp -lz -lbz2" (after "make" in ../graph).
+
+To execute:
+"./components edgelist.txt [output.txt]".
+"edgelist.txt" should contain the graph: one edge on each line (two unsigned long (nodes' ID)) separated by a space.
+The number of components, the size of the largest one and the histogram of the sizes ("size number_of_components" by increasing size) are printed in the terminal.
+"output.txt" will contain the component of every node: "nodeID componentID" on each line, the components being numbered 0,1,2... by decreasing size.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>//to estimate the runing time
+
+#include "graph.h"
+
+int main(int argc,char** argv){
+	adjlist* g;
+	node_t *comp;
+	unsigned long *size,*hist,*bin,nc,u,s,maxs=0;
+	uint64_t *rank;
+
+	time_t t1,t2;
+
+	if (argc<2) {
+		fprintf(stderr,"Usage: %s edgelist.txt [output.txt]\n",argv[0]);
+		return 1;
+	}
+
+	t1=time(NULL);
+
+	printf("Reading graph from file %s\n",argv[1]);
+	g=loadadjlist(argv[1],0);
+
+	printf("Number of nodes: %lu\n",g->n);
+	printf("Number of edges: %lu\n",g->e);
+
+	comp=malloc(g->n*sizeof(node_t));
+	nc=connected_components(g,comp);
+	printf("Number of connected components: %lu\n",nc);
+
+	//size of every component, indexed by its smallest node
+	size=calloc(g->n,sizeof(unsigned long));
+	for (u=0;u<g->n;u++)
+		size[comp[u]]++;
+	for (u=0;u<g->n;u++)
+		if (size[u]>maxs)
+			maxs=size[u];
+	printf("Largest connected component: %lu nodes (%f%% of the nodes)\n",maxs,(g->n>0)?100.*maxs/g->n:0.);
+
+	//histogram of the sizes
+	hist=calloc(maxs+2,sizeof(unsigned long));
+	for (u=0;u<g->n;u++)
+		if (comp[u]==u)
+			hist[size[u]]++;
+	printf("Sizes of the components (size number):\n");
+	for (s=1;s<=maxs;s++)
+		if (hist[s]>0)
+			printf("%lu %lu\n",s,hist[s]);
+
+	if (argc>2) {
+		//components numbered by decreasing size (counting sort, by smallest node on ties)
+		bin=calloc(maxs+2,sizeof(unsigned long));
+		for (s=maxs;s>0;s--)
+			bin[s-1]=bin[s]+hist[s];
+		rank=malloc(g->n*sizeof(uint64_t));
+		for (u=0;u<g->n;u++)
+			if (comp[u]==u)
+				rank[u]=bin[size[u]]++;
+		for (u=0;u<g->n;u++)
+			rank[u]=rank[comp[u]];//the roots keep their own rank
+		printf("Writting to file %s\n",argv[2]);
+		writevalues(g,rank,VAL_U64,argv[2]);
+		free(rank);
+		free(bin);
+	}
+
+	free(hist);
+	free(size);
+	free(comp);
+	free_adjlist(g);
+
+	t2=time(NULL);
+
+	printf("- Overall time = %ldh%ldm%lds\n",(t2-t1)/3600,((t2-t1)%3600)/60,((t2-t1)%60));
+
+	return 0;
+}
@@ -5,20 +5,30 @@ http://bit.ly/danisch
 maximilien.danisch@gmail.com
 
 Info:
-Feel free to use these lines as you wish. This program computes an approximation (lower bound) to the diameter of the graph using few BFS such as described in https://arxiv.org/abs/0904.2728. The graph is assumed to be undirected.
+Feel free to use these lines as you wish. This program computes the exact diameter and radius of the graph using few BFS, by bounding the eccentricities of the nodes (see ../graph/eccentricity.c). The graph is assumed to be undirected.
 
 To compile:
-"gcc diameter.c -O9 -o diameter".
+"gcc diameter.c -O9 -o diameter -I../graph ../graph/libgraph.a -fopenmp -lz -lbz2" (after "make" in ../graph).
 
 To execute:
-"./diameter edgelist.txt".
+"./diameter edgelist.txt [time=seconds] [ecc=output.txt]".
 "edgelist.txt" should contain the graph: one edge on each line (two unsigned long (nodes' ID)) separated by a space.
-The approximation (lower bound) to diameter will be printed in the terminal.
-type "ctrl C" to stop the program.
+The diameter (largest distance over all the connected components) and the radius of the largest component will be printed in the terminal, with the number of BFS used.
+With "ecc=output.txt", the eccentricity of every node is computed instead: "output.txt" will contain "nodeID eccentricity" on each line
+and the distribution of the eccentricities ("eccentricity number_of_nodes") is printed in the terminal.
+With "time=seconds", the search stops after this time and the best bounds found are printed instead (with "ecc=", the lower bounds
+are written in "output.txt" and the upper bounds in "output.txt.upper").
+
+How it works:
+A 4-sweep (double sweep twice, such as described in https://arxiv.org/abs/0904.2728) gives a lower bound on the diameter and a central node,
+then every BFS from a node v bounds the eccentricity of all the nodes w (between max(d(v,w),ecc(v)-d(v,w)) and ecc(v)+d(v,w)),
+and BFS are run from the nodes whose bounds are the most open (one per thread) until the bounds on the diameter and the radius meet.
+With "ecc=", the BFS go on until the bounds of every node meet, the nodes far from a central node being also searched first as they bound the others;
+the nodes of degree 1 are never searched, their eccentricity is the one of their neighbor plus 1.
 
 Note:
-If the graph is directed (and weighted) with selfloops and you want to make it undirected unweighted without selfloops, use the following linux command line.
-awk '{if ($1<$2) print $1" "$2;else if ($2<$1) print $2" "$1}' net.txt | sort -n -k1,2 -u > net2.txt
+If the graph is directed (and weighted) with selfloops and you want to make it undirected unweighted without selfloops, use the canonicalizer of the root directory (parallel, and it also works on files larger than the memory).
+../canon.exe net.txt net2.txt
 
 Performance:
 Up to 500 million edges on my laptop with 8G of RAM.
@@ -26,178 +36,100 @@ Up to 500 million edges on my laptop with 8G of RAM.
 
 #include <stdlib.h>
 #include <stdio.h>
-#include <stdbool.h>
+#include <string.h>
 #include <time.h>//to estimate the runing time
 
-#define NLINKS 100000000 //maximum number of edges for memory allocation, will increase if needed
-
-typedef struct {
-	unsigned long s;
-	unsigned long t;
-} edge;
-
-//edge list structure:
-typedef struct {
-	unsigned long n;//number of nodes
-	unsigned long e;//number of edges
-	edge *edges;//list of edges
-	unsigned long *cd;//cumulative degree cd[0]=0 length=n+1
-	unsigned long *adj;//concatenated lists of neighbors of all nodes
-} adjlist;
-
-//compute the maximum of three unsigned long
-inline unsigned long max3(unsigned long a,unsigned long b,unsigned long c){
-	a=(a>b) ? a : b;
-	return (a>c) ? a : c;
-}
-
-//reading the edgelist from file
-adjlist* readedgelist(char* input){
-	unsigned long e1=NLINKS;
-	adjlist *g=malloc(sizeof(adjlist));
-	FILE *file;
-
-	g->n=0;
-	g->e=0;
-	file=fopen(input,"r");
-	g->edges=malloc(e1*sizeof(edge));
-	while (fscanf(file,"%lu %lu", &(g->edges[g->e].s), &(g->edges[g->e].t))==2) {
-		g->n=max3(g->n,g->edges[g->e].s,g->edges[g->e].t);
-		if (g->e++==e1) {
-			e1+=NLINKS;
-			g->edges=realloc(g->edges,e1*sizeof(edge));
-		}
-	}
-	fclose(file);
-	g->n++;
-
-	g->edges=realloc(g->edges,g->e*sizeof(edge));
-
-	return g;
-}
-
-//building the adjacency list
-void mkadjlist(adjlist* g){
-	unsigned long i,u,v;
-	unsigned long *d=calloc(g->n,sizeof(unsigned long));
-
-	for (i=0;i<g->e;i++) {
-		d[g->edges[i].s]++;
-		d[g->edges[i].t]++;
-	}
+#include "graph.h"
 
-	g->cd=malloc((g->n+1)*sizeof(unsigned long));
-	g->cd[0]=0;
-	for (i=1;i<g->n+1;i++) {
-		g->cd[i]=g->cd[i-1]+d[i-1];
-		d[i-1]=0;
-	}
-
-	g->adj=malloc(2*g->e*sizeof(unsigned long));
+//eccentricity of every node in output, lower and upper bounds if the time budget expired
+static void alleccentricities(adjlist *g,double budget,char *output){
+	unsigned *lo=malloc(g->n*sizeof(unsigned)),*hi=malloc(g->n*sizeof(unsigned));
+	unsigned long nbfs,u,open=0,e,*hist,maxe=0;
+	char *upper;
 
-	for (i=0;i<g->e;i++) {
-		u=g->edges[i].s;
-		v=g->edges[i].t;
-		g->adj[ g->cd[u] + d[u]++ ]=v;
-		g->adj[ g->cd[v] + d[v]++ ]=u;
+	nbfs=eccentricities(g,budget,lo,hi);
+	for (u=0;u<g->n;u++) {
+		if (lo[u]<hi[u])
+			open++;
+		if (hi[u]>maxe)
+			maxe=hi[u];
 	}
-
-	free(d);
-	free(g->edges);
-}
-
-//freeing memory
-void free_adjlist(adjlist *g){
-	//free(g->edges);
-	free(g->cd);
-	free(g->adj);
-	free(g);
-}
-
-
-unsigned *bfs(adjlist *g,unsigned long u) {
-	unsigned long n=g->n,l=1,i,j,v;
-
-	static unsigned *dist=NULL,*list=NULL;
-
-	if (dist==NULL){
-		dist=malloc(n*sizeof(unsigned));
-		list=malloc(n*sizeof(unsigned));//this will not be freed
+	printf("Number of BFS: %lu\n",nbfs);
+	if (open==0) {
+		printf("diameter = %lu\n",maxe);
+		hist=calloc(maxe+1,sizeof(unsigned long));
+		for (u=0;u<g->n;u++)
+			hist[lo[u]]++;
+		printf("Distribution of the eccentricities (eccentricity number):\n");
+		for (e=0;e<=maxe;e++)
+			if (hist[e]>0)
+				printf("%lu %lu\n",e,hist[e]);
+		free(hist);
+		printf("Writting to file %s\n",output);
+		writevalues(g,lo,VAL_U32,output);
 	}
-
-	for (i=0;i<n;i++) {
-		dist[i]=-1;
-	}
-
-	list[0]=u;
-	
-	dist[u]=0;
-
-	for (i=0;i<l;i++) {
-		v=list[i];
-		for (j=g->cd[v];j<g->cd[v+1];j++) {
-			if (dist[g->adj[j]]==-1) {
-				list[l++]=g->adj[j];
-				dist[g->adj[j]]=dist[v]+1;
-			}
-		}
-	}
-
-	return dist;
-
-}
-
-unsigned long maxvect(unsigned long n, unsigned* vect){
-	unsigned long i,imax;
-	unsigned vmax=0;
-	for (i=0;i<n;i++){
-		if ((vect[i]!=-1) && (vect[i]>=vmax)){
-			imax=i;
-			vmax=vect[i];
+	else {
+		printf("%lu nodes have bounds only (time budget reached)\n",open);
+		printf("Writting the lower bounds to file %s\n",output);
+		writevalues(g,lo,VAL_U32,output);
+		if (strcmp(output,"-")!=0) {
+			upper=malloc(strlen(output)+7);
+			sprintf(upper,"%s.upper",output);
+			printf("Writting the upper bounds to file %s\n",upper);
+			writevalues(g,hi,VAL_U32,upper);
+			free(upper);
 		}
 	}
-	return imax;
+	free(lo);
+	free(hi);
 }
 
 int main(int argc,char** argv){
 	adjlist* g;
-	unsigned *dist,dmax=0;
-	unsigned long i,u=0;
-;
-	bool *chosen;
-	FILE* file;
+	unsigned dlb,dub,rlb,rub;
+	unsigned long nbfs;
+	double budget=0;
+	char *ecc=NULL;
+	int i;
 
 	time_t t1,t2;
 
+	if (argc<2) {
+		fprintf(stderr,"Usage: %s edgelist.txt [time=seconds] [ecc=output.txt]\n",argv[0]);
+		return 1;
+	}
+	for (i=2;i<argc;i++) {
+		if (strncmp(argv[i],"time=",5)==0)
+			budget=atof(argv[i]+5);
+		else if (strncmp(argv[i],"ecc=",4)==0)
+			ecc=argv[i]+4;
+		else {
+			fprintf(stderr,"Unknown option %s\n",argv[i]);
+			return 1;
+		}
+	}
 
-	printf("Reading edgelist from file %s\n",argv[1]);
-	g=readedgelist(argv[1]);
+	printf("Reading graph from file %s\n",argv[1]);
+	g=loadadjlist(argv[1],0);
 
 	printf("Number of nodes: %lu\n",g->n);
 	printf("Number of edges: %lu\n",g->e);
 
-	printf("Building the adjacency list\n");
-	mkadjlist(g);
-
 	t1=time(NULL);
-	chosen=calloc(g->n,sizeof(bool));
-	for (i=0;i<100;i++) {
-		if (chosen[u]==0)
-			i--;
-		else {
-			u=i;
-			if (chosen[u]==1)
-				continue;
-		}
-		chosen[u]=1;
-		printf("Computing distances from node %lu\n",u);
-		dist=bfs(g,u);
-
-		u=maxvect(g->n,dist);
-		dmax=(dmax>dist[u])?dmax:dist[u];
-		printf("lower bound on diameter = %u\n",dmax);
-	} 
-	printf("diameter = %u\n",dmax);
+	if (ecc!=NULL)
+		alleccentricities(g,budget,ecc);
+	else {
+		nbfs=diameter_radius(g,budget,&dlb,&dub,&rlb,&rub);
+		printf("Number of BFS: %lu\n",nbfs);
+		if (dlb==dub)
+			printf("diameter = %u\n",dlb);
+		else
+			printf("%u <= diameter <= %u (time budget reached)\n",dlb,dub);
+		if (rlb==rub)
+			printf("radius = %u\n",rlb);
+		else
+			printf("%u <= radius <= %u (time budget reached)\n",rlb,rub);
+	}
 
 	free_adjlist(g);
 
@@ -207,4 +139,3 @@ int main(int argc,char** argv){
 
 	return 0;
 }
-
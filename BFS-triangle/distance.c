@@ -0,0 +1,176 @@
+/*
+Info:
+Feel free to use these lines as you wish. This program answers shortest path queries between pairs of nodes, the graph being loaded once for all of them. The graph is assumed to be undirected.
+
+To compile:
+"gcc distance.c -O3 -o distance -I../graph ../graph/libgraph.a -fopenmp -lz -lbz2" (after "make" in ../graph).
+
+To execute:
+"./distance edgelist.txt queries.txt output.txt [path]".
+"edgelist.txt" should contain the graph: one edge on each line (two unsigned long (nodes' ID)) separated by a space.
+"queries.txt" should contain the queries: two nodes' ID separated by a space on each line ("-" reads them from the standard input, lines starting with '#' or '%' are skipped).
+"output.txt" will contain the answers in the order of the queries: "s t distance" on each line, the distance being -1 if t cannot be reached from s
+(or if one of the nodes is not in the graph). With "path", the nodes of a shortest path from s to t follow the distance on the line.
+"-" writes them to the standard output.
+The number of queries answered per second is printed in the terminal (on the standard error output if the answers go to the standard output).
+
+How it works:
+The queries are read by batches of QUERY_BATCH and answered in parallel, each thread running a bidirectional BFS in its own pair of workspaces (see ../graph/bidir.c):
+a query only costs the part of the graph around s and t that the two searches visit before they meet, not a BFS of the whole graph.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>//to estimate the runing time
+#include <omp.h>
+
+#include "graph.h"
+
+//per-thread storage of the paths of a batch
+typedef struct {
+	node_t *p;
+	unsigned long len,size;
+} pathpool;
+
+int main(int argc,char** argv){
+	adjlist* g;
+	bfsctx **fw,**bw;
+	pathpool *pool;
+	node_t **tmp;
+	uint64_t *qs,*qt;
+	unsigned *dist;
+	unsigned long *off,nq,total=0,reached=0,line=0,j;
+	int *owner,withpath=0,nt,t;
+	double qtime=0,t0;
+	FILE *in,*out,*info;
+
+	time_t t1,t2;
+
+	if (argc<4) {
+		fprintf(stderr,"Usage: %s edgelist.txt queries.txt output.txt [path]\n",argv[0]);
+		return 1;
+	}
+	if (argc>4) {
+		if (strcmp(argv[4],"path")!=0) {
+			fprintf(stderr,"Unknown option %s\n",argv[4]);
+			return 1;
+		}
+		withpath=1;
+	}
+	in=(strcmp(argv[2],"-")==0) ? stdin : fopen(argv[2],"r");
+	if (in==NULL) {
+		fprintf(stderr,"Cannot read %s\n",argv[2]);
+		return 1;
+	}
+	out=(strcmp(argv[3],"-")==0) ? stdout : fopen(argv[3],"w");
+	if (out==NULL) {
+		fprintf(stderr,"Cannot write %s\n",argv[3]);
+		return 1;
+	}
+	info=(out==stdout) ? stderr : stdout;
+
+	t1=time(NULL);
+
+	fprintf(info,"Reading graph from file %s\n",argv[1]);
+	g=loadadjlist(argv[1],0);
+
+	fprintf(info,"Number of nodes: %lu\n",g->n);
+	fprintf(info,"Number of edges: %lu\n",g->e);
+
+	nt=omp_get_max_threads();
+	fw=malloc(nt*sizeof(bfsctx*));
+	bw=malloc(nt*sizeof(bfsctx*));
+	pool=calloc(nt,sizeof(pathpool));
+	tmp=calloc(nt,sizeof(node_t*));
+	for (t=0;t<nt;t++) {
+		fw[t]=mkbfsctx(g);
+		bw[t]=mkbfsctx(g);
+		if (withpath)
+			tmp[t]=malloc(g->n*sizeof(node_t));
+	}
+	qs=malloc(QUERY_BATCH*sizeof(uint64_t));
+	qt=malloc(QUERY_BATCH*sizeof(uint64_t));
+	dist=malloc(QUERY_BATCH*sizeof(unsigned));
+	off=malloc(QUERY_BATCH*sizeof(unsigned long));
+	owner=malloc(QUERY_BATCH*sizeof(int));
+
+	fprintf(info,"Answering the queries of %s\n",argv[2]);
+	while ((nq=readqueries(in,qs,qt,&line))>0) {
+		for (t=0;t<nt;t++)
+			pool[t].len=0;
+		t0=omp_get_wtime();
+		#pragma omp parallel for schedule(dynamic,16) num_threads(nt)
+		for (j=0;j<nq;j++) {
+			int th=omp_get_thread_num();
+			unsigned long s=findnode(g,qs[j]),u=findnode(g,qt[j]);
+			pathpool *pp=pool+th;
+
+			owner[j]=th;
+			if (s==NONODE || u==NONODE) {
+				dist[j]=-1;
+				continue;
+			}
+			dist[j]=bidir_bfs(g,fw[th],bw[th],s,u,tmp[th]);
+			if (withpath && dist[j]!=(unsigned)-1) {
+				if (pp->len+dist[j]+1>pp->size) {
+					pp->size=2*(pp->len+dist[j]+1);
+					pp->p=realloc(pp->p,pp->size*sizeof(node_t));
+				}
+				off[j]=pp->len;
+				memcpy(pp->p+pp->len,tmp[th],(dist[j]+1)*sizeof(node_t));
+				pp->len+=dist[j]+1;
+			}
+		}
+		qtime+=omp_get_wtime()-t0;
+
+		for (j=0;j<nq;j++) {
+			if (dist[j]==(unsigned)-1) {
+				fprintf(out,"%llu %llu -1\n",(unsigned long long)qs[j],(unsigned long long)qt[j]);
+				continue;
+			}
+			reached++;
+			fprintf(out,"%llu %llu %u",(unsigned long long)qs[j],(unsigned long long)qt[j],dist[j]);
+			if (withpath) {
+				node_t *p=pool[owner[j]].p+off[j];
+				unsigned i;
+				for (i=0;i<=dist[j];i++)
+					fprintf(out," %llu",(unsigned long long)nodeid(g,p[i]));
+			}
+			fputc('\n',out);
+		}
+		total+=nq;
+	}
+	if (in!=stdin)
+		fclose(in);
+	if ((out==stdout) ? fflush(out)!=0 : fclose(out)!=0) {
+		fprintf(stderr,"Error while writing %s\n",argv[3]);
+		return 1;
+	}
+
+	fprintf(info,"Number of queries: %lu (%lu connected pairs)\n",total,reached);
+	fprintf(info,"Time spent on the queries: %f seconds, %.0f queries per second\n",qtime,(qtime>0) ? total/qtime : 0.);
+
+	for (t=0;t<nt;t++) {
+		free_bfsctx(fw[t]);
+		free_bfsctx(bw[t]);
+		free(pool[t].p);
+		free(tmp[t]);
+	}
+	free(fw);
+	free(bw);
+	free(pool);
+	free(tmp);
+	free(qs);
+	free(qt);
+	free(dist);
+	free(off);
+	free(owner);
+	free_adjlist(g);
+
+	t2=time(NULL);
+
+	fprintf(info,"- Overall time = %ldh%ldm%lds\n",(t2-t1)/3600,((t2-t1)%3600)/60,((t2-t1)%60));
+
+	return 0;
+}
@@ -0,0 +1,83 @@
+/*
+Info:
+Feel free to use these lines as you wish. This program builds a landmark index of the graph, from which ./lmquery answers distance queries without the graph (see ../graph/landmark.c). The graph is assumed to be undirected.
+
+To compile:
+"gcc landmarks.c -O3 -o landmarks -I../graph ../graph/libgraph.a -fopenmp -lz -lbz2" (after "make" in ../graph).
+
+To execute:
+"./landmarks edgelist.txt index.lmk [k=16] [random] [labels]".
+"edgelist.txt" should contain the graph: one edge on each line (two unsigned long (nodes' ID)) separated by a space.
+"index.lmk" will contain the index: the distances from k landmarks (16 by default) to every node, on one byte each.
+The landmarks are the k nodes of largest degree, or k nodes drawn uniformly at random with "random".
+With "labels", the index also holds a pruned landmark labeling, from which ./lmquery gives the exact distances (sequential,
+for graphs of a few million edges and of diameter less than 255).
+
+How it works:
+One direction-optimizing BFS on all the cores per landmark (see ../graph/bfs.c), the distances being stored node by node so that
+a query reads two rows of k consecutive bytes.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>//to estimate the runing time
+
+#include "graph.h"
+
+#define LANDMARKS 16
+
+int main(int argc,char** argv){
+	adjlist* g;
+	unsigned long k=LANDMARKS,nlab;
+	int select=LM_DEGREE,labels=0,i;
+
+	time_t t1,t2;
+
+	if (argc<3) {
+		fprintf(stderr,"Usage: %s edgelist.txt index.lmk [k=16] [random] [labels]\n",argv[0]);
+		return 1;
+	}
+	for (i=3;i<argc;i++) {
+		if (strncmp(argv[i],"k=",2)==0)
+			k=strtoul(argv[i]+2,NULL,10);
+		else if (strcmp(argv[i],"random")==0)
+			select=LM_RANDOM;
+		else if (strcmp(argv[i],"labels")==0)
+			labels=1;
+		else {
+			fprintf(stderr,"Unknown option %s\n",argv[i]);
+			return 1;
+		}
+	}
+	if (k==0) {
+		fprintf(stderr,"k should be at least 1\n");
+		return 1;
+	}
+
+	t1=time(NULL);
+
+	printf("Reading graph from file %s\n",argv[1]);
+
+	g=loadadjlist(argv[1],0);
+
+	printf("Number of nodes: %lu\n",g->n);
+	printf("Number of edges: %lu\n",g->e);
+
+	if (k>g->n)
+		k=g->n;
+	printf("Building the index with %lu landmarks (%s)%s\n",k,(select==LM_DEGREE)?"largest degrees":"random",labels?" and the labels":"");
+	nlab=mklandmarks(g,k,select,time(NULL),labels,argv[2]);
+	printf("Size of the distances: %lu bytes\n",g->n*k);
+	if (labels)
+		printf("Number of label entries: %lu (%.1f per node)\n",nlab,(g->n>0)?(double)nlab/g->n:0.);
+	printf("Index written to file %s\n",argv[2]);
+
+	free_adjlist(g);
+
+	t2=time(NULL);
+
+	printf("- Overall time = %ldh%ldm%lds\n",(t2-t1)/3600,((t2-t1)%3600)/60,((t2-t1)%60));
+
+	return 0;
+}
@@ -0,0 +1,127 @@
+/*
+Info:
+Feel free to use these lines as you wish. This program answers distance queries between pairs of nodes with a landmark index built by ./landmarks, without loading the graph.
+
+To compile:
+"gcc lmquery.c -O3 -o lmquery -I../graph ../graph/libgraph.a -fopenmp -lz -lbz2" (after "make" in ../graph).
+
+To execute:
+"./lmquery index.lmk queries.txt output.txt".
+"index.lmk" is the index built by "./landmarks edgelist.txt index.lmk".
+"queries.txt" should contain the queries: two nodes' ID separated by a space on each line ("-" reads them from the standard input, lines starting with '#' or '%' are skipped).
+"output.txt" will contain the answers in the order of the queries: "s t lower upper" on each line. Both bounds are -1 when a landmark proves
+that t cannot be reached from s (or if one of the nodes is not in the graph); otherwise an upper bound of -1 only means that it is unknown.
+If the index holds the labels, the exact distance follows.
+"-" writes them to the standard output.
+The number of queries answered per second is printed in the terminal (on the standard error output if the answers go to the standard output).
+
+How it works:
+The index is mapped in memory (concurrent programs share it in the page cache), and the bounds of a query are given by the triangle
+inequality on each landmark: |d(l,s)-d(l,t)| <= d(s,t) <= d(l,s)+d(l,t) (see ../graph/landmark.c). The queries are answered in parallel by batches of QUERY_BATCH.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>//to estimate the runing time
+#include <omp.h>
+
+#include "graph.h"
+
+//-1 for an infinite bound
+static void putbound(FILE *file,unsigned d){
+	if (d==(unsigned)-1)
+		fputs(" -1",file);
+	else
+		fprintf(file," %u",d);
+}
+
+int main(int argc,char** argv){
+	lmindex *x;
+	uint64_t *qs,*qt;
+	unsigned *lo,*hi,*ex;
+	unsigned long nq,total=0,line=0,j;
+	double qtime=0,t0;
+	FILE *in,*out,*info;
+
+	time_t t1,t2;
+
+	if (argc<4) {
+		fprintf(stderr,"Usage: %s index.lmk queries.txt output.txt\n",argv[0]);
+		return 1;
+	}
+	in=(strcmp(argv[2],"-")==0) ? stdin : fopen(argv[2],"r");
+	if (in==NULL) {
+		fprintf(stderr,"Cannot read %s\n",argv[2]);
+		return 1;
+	}
+	out=(strcmp(argv[3],"-")==0) ? stdout : fopen(argv[3],"w");
+	if (out==NULL) {
+		fprintf(stderr,"Cannot write %s\n",argv[3]);
+		return 1;
+	}
+	info=(out==stdout) ? stderr : stdout;
+
+	t1=time(NULL);
+
+	fprintf(info,"Mapping the index %s\n",argv[1]);
+	x=maplandmarks(argv[1]);
+
+	fprintf(info,"Number of nodes: %lu\n",x->n);
+	fprintf(info,"Number of landmarks: %lu%s\n",x->k,(x->flags & LM_LABELS)?", with the labels":"");
+
+	qs=malloc(QUERY_BATCH*sizeof(uint64_t));
+	qt=malloc(QUERY_BATCH*sizeof(uint64_t));
+	lo=malloc(QUERY_BATCH*sizeof(unsigned));
+	hi=malloc(QUERY_BATCH*sizeof(unsigned));
+	ex=malloc(QUERY_BATCH*sizeof(unsigned));
+
+	fprintf(info,"Answering the queries of %s\n",argv[2]);
+	while ((nq=readqueries(in,qs,qt,&line))>0) {
+		t0=omp_get_wtime();
+		#pragma omp parallel for schedule(static,1024)
+		for (j=0;j<nq;j++) {
+			unsigned long s=lm_row(x,qs[j]),t=lm_row(x,qt[j]);
+			if (s==NONODE || t==NONODE) {
+				lo[j]=hi[j]=ex[j]=-1;
+				continue;
+			}
+			lm_bounds(x,s,t,lo+j,hi+j);
+			if (x->flags & LM_LABELS)
+				ex[j]=lm_exact(x,s,t);
+		}
+		qtime+=omp_get_wtime()-t0;
+
+		for (j=0;j<nq;j++) {
+			fprintf(out,"%llu %llu",(unsigned long long)qs[j],(unsigned long long)qt[j]);
+			putbound(out,lo[j]);
+			putbound(out,hi[j]);
+			if (x->flags & LM_LABELS)
+				putbound(out,ex[j]);
+			fputc('\n',out);
+		}
+		total+=nq;
+	}
+	if (in!=stdin)
+		fclose(in);
+	if ((out==stdout) ? fflush(out)!=0 : fclose(out)!=0) {
+		fprintf(stderr,"Error while writing %s\n",argv[3]);
+		return 1;
+	}
+
+	fprintf(info,"Number of queries: %lu\n",total);
+	fprintf(info,"Time spent on the queries: %f seconds, %.0f queries per second\n",qtime,(qtime>0) ? total/qtime : 0.);
+
+	free(qs);
+	free(qt);
+	free(lo);
+	free(hi);
+	free(ex);
+	free_lmindex(x);
+
+	t2=time(NULL);
+
+	fprintf(info,"- Overall time = %ldh%ldm%lds\n",(t2-t1)/3600,((t2-t1)%3600)/60,((t2-t1)%60));
+
+	return 0;
+}
@@ -8,111 +8,60 @@ Info:
 Feel free to use these lines as you wish. This program loads an unweighetd graph in main memory as an adjacency matrix.
 
 To compile:
-"gcc adjmatrix.c -O9 -o adjmatrix".
+"gcc adjmatrix.c -O9 -o adjmatrix -Igraph graph/libgraph.a -fopenmp -lz -lbz2" (after "make" in graph).
 
 To execute:
 "./adjmatrix edgelist.txt".
 "edgelist.txt" should contain the graph: one edge on each line (two unsigned long (nodes' ID)) separated by a space.
-The prograph will load the graph in main memory and then terminate.
+The prograph will load the graph in main memory, count its triangles and compute the distances from node 0 (the first node), then terminate.
+The matrix is stored as bitset rows (see graph/bitmatrix.c): one bit per pair of nodes and 64 pairs (or more with AVX2) per instruction.
+Compile with -march=native (or -mavx2) in graph/Makefile to use 256-bit vectors.
 
 Note:
-If the graph is directed (and weighted) with selfloops and you want to make it undirected unweighted without selfloops, use the following linux command line.
-awk '{if ($1<$2) print $1" "$2;else if ($2<$1) print $2" "$1}' net.txt | sort -n -k1,2 -u > net2.txt
+If the graph is directed (and weighted) with selfloops and you want to make it undirected unweighted without selfloops, use the canonicalizer of the root directory (parallel, and it also works on files larger than the memory).
+./canon.exe net.txt net2.txt
 
 Performence:
-Up to 200.000 nodes on my laptop with 8G of RAM.
-Takes more or less 4G of RAM and 10 seconds (I have an SSD hardrive) for 100.000 nodes.
+The matrix takes n*n/8 bytes: 1.25G of RAM for 100.000 nodes, up to about 250.000 nodes with 8G of RAM.
 */
 
 #include <stdlib.h>
 #include <stdio.h>
-#include <stdbool.h>
 #include <time.h>//to estimate the runing time
 
-#define NLINKS 100000000 //maximum number of edges for memory allocation, will increase if needed
-
-typedef struct {
-	unsigned long s;
-	unsigned long t;
-} edge;
-
-//edge list structure:
-typedef struct {
-	unsigned long n;//number of nodes
-	unsigned long e;//number of edges
-	edge *edges;//list of edges
-	bool *mat;//adjacency matrix
-} adjmatrix;
-
-//compute the maximum of three unsigned long
-inline unsigned long max3(unsigned long a,unsigned long b,unsigned long c){
-	a=(a>b) ? a : b;
-	return (a>c) ? a : c;
-}
-
-//reading the edgelist from file
-adjmatrix* readedgelist(char* input){
-	unsigned long e1=NLINKS;
-	FILE *file=fopen(input,"r");
-
-	adjmatrix *g=malloc(sizeof(adjmatrix));
-	g->n=0;
-	g->e=0;
-	g->edges=malloc(e1*sizeof(edge));//allocate some RAM to store edges
-
-	while (fscanf(file,"%lu %lu", &(g->edges[g->e].s), &(g->edges[g->e].t))==2) {
-		g->n=max3(g->n,g->edges[g->e].s,g->edges[g->e].t);
-		if (++(g->e)==e1) {//increase allocated RAM if needed
-			e1+=NLINKS;
-			g->edges=realloc(g->edges,e1*sizeof(edge));
-		}
-	}
-	fclose(file);
-
-	g->n++;
-
-	g->edges=realloc(g->edges,g->e*sizeof(edge));
-
-	return g;
-}
-
-//building the adjacency matrix
-void mkmatrix(adjmatrix* g){
-	printf("%lu\n",g->n*g->n);
-	unsigned long i,u,v;
-	g->mat=calloc(g->n*g->n,sizeof(bool));
-	for (i=0;i<g->e;i++){
-		u=g->edges[i].s;
-		v=g->edges[i].t;
-		printf("%lu,%lu\n",u+g->n*v,v+g->n*u);
-		g->mat[u+g->n*v]=1;
-		g->mat[v+g->n*u]=1;
-	}
-}
-
-
-void free_adjmatrix(adjmatrix *g){
-	free(g->edges);
-	free(g->mat);
-	free(g);
-}
+#include "graph.h"
 
 int main(int argc,char** argv){
-	adjmatrix* g;
+	edgelist* el;
+	bitmatrix* g;
+	unsigned *dist;
+	unsigned long i,r=0;
 	time_t t1,t2;
 
 	t1=time(NULL);
 
 	printf("Reading edgelist from file %s\n",argv[1]);
-	g=readedgelist(argv[1]);
+	el=readedgelist(argv[1]);
 
-	printf("Number of nodes: %lu\n",g->n);
-	printf("Number of edges: %lu\n",g->e);
+	printf("Number of nodes: %lu\n",el->n);
+	printf("Number of edges: %lu\n",el->e);
 
-	printf("Building the adjacency matrix\n");
-	mkmatrix(g);
-	
-	free_adjmatrix(g);
+	printf("Building the adjacency matrix (%lu bytes)\n",(unsigned long)(el->n*(((el->n+255)/256)*32)));
+	g=mkbitmatrix(el);
+	free_edgelist(el);
+
+	printf("Number of triangles: %lu\n",bm_triangles(g));
+
+	if (g->n>0) {
+		dist=bm_bfs(g,0);
+		for (i=0;i<g->n;i++)
+			if (dist[i]!=(unsigned)-1)
+				r++;
+		printf("Nodes reachable from the first node: %lu\n",r);
+		free(dist);
+	}
+
+	free_bitmatrix(g);
 
 	t2=time(NULL);
 
@@ -120,5 +69,3 @@ int main(int argc,char** argv){
 
 	return 0;
 }
-
-
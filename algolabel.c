@@ -8,7 +8,7 @@ Info:
 Feel free to use these lines as you wish. This program computes shortest paths using BFS. The graph is assumed to be undirected.
 
 To compile:
-"gcc bfs.c -O9 -o bfs".
+"gcc bfs.c -O9 -o bfs -Igraph graph/libgraph.a -fopenmp -lz -lbz2" (after "make" in graph).
 
 To execute:
 "./bfs edgelist.txt n1 n2 n3 ... n_k".
@@ -16,8 +16,8 @@ To execute:
 It computes the shotest path from node n1 to all nodes in the graph and writes the result in a file called "n1". It the does the same for n2, n3,... and n_k
 
 Note:
-If the graph is directed (and weighted) with selfloops and you want to make it undirected unweighted without selfloops, use the following linux command line.
-awk '{if ($1<$2) print $1" "$2;else if ($2<$1) print $2" "$1}' net.txt | sort -n -k1,2 -u > net2.txt
+If the graph is directed (and weighted) with selfloops and you want to make it undirected unweighted without selfloops, use the canonicalizer of the root directory (parallel, and it also works on files larger than the memory).
+./canon.exe net.txt net2.txt
 
 Performance:
 Up to 500 million edges on my laptop with 8G of RAM:
@@ -28,95 +28,7 @@ Takes more or less 1.6G of RAM and 25 seconds (I have an SSD hardrive) for 100M
 #include <stdio.h>
 #include <time.h>//to estimate the runing time
 
-#define NLINKS 100000000 //maximum number of edges for memory allocation, will increase if needed
-
-typedef struct {
-	unsigned long s;
-	unsigned long t;
-} edge;
-
-//edge list structure:
-typedef struct {
-	unsigned long n;//number of nodes
-	unsigned long e;//number of edges
-	edge *edges;//list of edges
-	unsigned long *cd;//cumulative degree cd[0]=0 length=n+1
-	unsigned long *adj;//concatenated lists of neighbors of all nodes
-	int *label; //label
-} adjlist;
-
-//compute the maximum of three unsigned long
-inline unsigned long max3(unsigned long a,unsigned long b,unsigned long c){
-	a=(a>b) ? a : b;
-	return (a>c) ? a : c;
-}
-
-//reading the edgelist from file
-adjlist* readedgelist(char* input){
-	unsigned long e1=NLINKS;
-	adjlist *g=malloc(sizeof(adjlist));
-	FILE *file;
-
-	g->n=0;
-	g->e=0;
-	file=fopen(input,"r");
-	g->edges=malloc(e1*sizeof(edge));
-	while (fscanf(file,"%lu %lu", &(g->edges[g->e].s), &(g->edges[g->e].t))==2) {
-		g->n=max3(g->n,g->edges[g->e].s,g->edges[g->e].t);
-		if (g->e++==e1) {
-			e1+=NLINKS;
-			g->edges=realloc(g->edges,e1*sizeof(edge));
-		}
-	}
-	fclose(file);
-	g->n++;
-
-	g->edges=realloc(g->edges,g->e*sizeof(edge));
-
-	return g;
-}
-
-//building the adjacency list
-void mkadjlist(adjlist* g){
-	unsigned long i,u,v;
-	unsigned long *d=calloc(g->n,sizeof(unsigned long));
-
-	for (i=0;i<g->e;i++) {
-		d[g->edges[i].s]++;
-		d[g->edges[i].t]++;
-	}
-
-	g->cd=malloc((g->n+1)*sizeof(unsigned long));
-	g->cd[0]=0;
-	for (i=1;i<g->n+1;i++) {
-		g->cd[i]=g->cd[i-1]+d[i-1];
-		d[i-1]=0;
-	}
-
-	g->adj=malloc(2*g->e*sizeof(unsigned long));
-	g->label = malloc(2*g->e*sizeof(int));
-	for (i=0; i<g->n;i++){ 
-		g->label[i]=i;
-	}
-	for (i=0;i<g->e;i++) {
-		u=g->edges[i].s;
-		v=g->edges[i].t;
-		g->adj[ g->cd[u] + d[u]++ ]=v;
-		g->adj[ g->cd[v] + d[v]++ ]=u; 
-		
-	}
-	
-	free(d);
-	//free(g->edges);
-}
-
-//freeing memory
-void free_adjlist(adjlist *g){
-	free(g->edges);
-	free(g->cd);
-	free(g->adj);
-	free(g);
-}
+#include "graph.h"
 
 
 //permet de trouver si deux liste de voisins ont un noeud en commun
@@ -148,6 +60,7 @@ void sortList(int *l, int n){
 
 int main(int argc,char** argv){
 	adjlist* g;
+	int *label;
 	unsigned *dist;
 	unsigned i;
 	unsigned long j,u;
@@ -156,10 +69,13 @@ int main(int argc,char** argv){
 	time_t t1,t2;
 
 	printf("readedge\n");
-	g=readedgelist(argv[1]);
+	g=loadadjlist(argv[1],0);
+	uncompress_adjlist(g);//label is indexed by the positions in adj
 
-	printf("mkadjlist\n");
-	mkadjlist(g);
+	label=malloc(g->n*sizeof(int));
+	for (i=0; i<g->n;i++){ 
+		label[i]=i;
+	}
 	
 	t1=time(NULL);
 	printf("step1\n");
@@ -167,9 +83,9 @@ int main(int argc,char** argv){
 	int *copyListNoeuds = malloc(g->n*sizeof(int));
 	int *listeLabelOld = malloc(g->n*sizeof(int));
 	for (i=0; i<g->n;i++){
-		copyListNoeuds[i]=g->label[i];
+		copyListNoeuds[i]=label[i];
 		listeLabelOld[i] = -1;
-		g->label[i] = -1;
+		label[i] = -1;
 	}
 
 	printf("step2\n");
@@ -189,15 +105,15 @@ int main(int argc,char** argv){
 		}
 	}
 	printf("step3\n");
-	g->label[indexClusters[0]] = 0;
+	label[indexClusters[0]] = 0;
 	listeLabelOld[i] = 0;
 	for(int i = 1; i < nbClusters; i++){
 		int isConnected = 0;		
 		for(int j = g->cd[i]; j < g->cd[i+1]; j++){
 			for(int k = 0; k < i; k++){
-				if(indexClusters[k] == g->adj[j] && g->label[j] >= 0){
-					g->label[i] = g->label[j];
-					listeLabelOld[i] = g->label[j];
+				if(indexClusters[k] == g->adj[j] && label[j] >= 0){
+					label[i] = label[j];
+					listeLabelOld[i] = label[j];
 					isConnected = 1;
 					break;
 				}
@@ -205,7 +121,7 @@ int main(int argc,char** argv){
 			if(isConnected) break;
 		}
 		if(!isConnected){						
-			g->label[i] = i;
+			label[i] = i;
 			listeLabelOld[i] = i;
 		}
 	}
@@ -222,7 +138,7 @@ int main(int argc,char** argv){
 			
 			int listeLabelsVoisins[degreI];
 			for(int j = 0; j < degreI ; j++){
-				listeLabelsVoisins[j] = g->label[g->adj[g->cd[i]+j]];
+				listeLabelsVoisins[j] = label[g->adj[g->cd[i]+j]];
 				//printf("%d %d\n",i,listeLabelsVoisins[j]);
 				if(listeLabelsVoisins[j] == -1){
 					degreI--;
@@ -263,34 +179,34 @@ int main(int argc,char** argv){
 			}
 			// choix du label
 			if(nbFrequents == 0){
-				g->label[i] = labelsFrequents[0];
+				label[i] = labelsFrequents[0];
 			}
 			if(nbFrequents > 0){ // condition inutile mais bon
 				int tmp = 0;
 				for(int j = 0; j < nbFrequents; j++){
-					if(g->label[i] == labelsFrequents[j]){
+					if(label[i] == labelsFrequents[j]){
 						tmp = 1;
 						break;
 					}
 				}
 				if(!tmp){ // si on a pas un label dans les + présents on en prend un des plus présents
-					g->label[i] = labelsFrequents[0];
+					label[i] = labelsFrequents[0];
 				}
 			}
 			//printf("%d\n",nbFrequents);			
 		}
 		boolContinue = 0;
 		for(int i = 0; i < g->n; i++){
-			if(g->label[i] != listeLabelOld[i]){
+			if(label[i] != listeLabelOld[i]){
 				boolContinue = 1;
-				listeLabelOld[i] = g->label[i];
+				listeLabelOld[i] = label[i];
 			}			
 		}
 		//printf("%d\n",emergencyExit);
 	} while(boolContinue && (emergencyExit--));
 	/*
 	for(int i = 0; i < g->n; i++){
-		printf("%d %d\n",i,g->label[i]);
+		printf("%d %d\n",i,label[i]);
 	}
 	*/
 
@@ -0,0 +1,65 @@
+/*
+Info:
+Feel free to use these lines as you wish. This program makes an edge list undirected, unweighted and without selfloops:
+every edge is written once as "min max", the edges are sorted and duplicates are removed.
+It replaces the command line "awk '{if ($1<$2) print $1" "$2;else if ($2<$1) print $2" "$1}' net.txt | sort -n -k1,2 -u > net2.txt":
+the input is parsed and sorted (radix sort) with all the cores, and inputs larger than the memory are sorted by parts on disk (see graph/canon.c).
+
+To compile:
+"gcc canon.c -O9 -o canon -Igraph graph/libgraph.a -fopenmp -lz -lbz2" (after "make" in graph).
+
+To execute:
+"./canon net.txt net2.txt [csr] [mem=MB] [tmp=directory]".
+"net.txt" should contain the graph: one edge on each line (two unsigned long (nodes' ID)) separated by a space, anything after is ignored.
+"net2.txt" will contain the canonical edge list ("-" for the standard output).
+With "csr", the output is a binary CSR file (see mkcsr.c) that all the tools accept in place of the edge list.
+"mem" is the memory used to sort (half of the RAM by default), above it sorted parts are written in "tmp" (TMPDIR or /tmp by default) and merged.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <time.h>//to estimate the runing time
+
+#include "graph.h"
+
+int main(int argc,char** argv){
+	int csr=0,i;
+	size_t mem=(size_t)sysconf(_SC_PHYS_PAGES)*sysconf(_SC_PAGESIZE)/2;
+	char *tmpdir=getenv("TMPDIR");
+	time_t t1,t2;
+
+	if (argc<3) {
+		fprintf(stderr,"Usage: %s net.txt net2.txt [csr] [mem=MB] [tmp=directory]\n",argv[0]);
+		return 1;
+	}
+	if (tmpdir==NULL)
+		tmpdir="/tmp";
+	for (i=3;i<argc;i++) {
+		if (strcmp(argv[i],"csr")==0)
+			csr=1;
+		else if (strncmp(argv[i],"mem=",4)==0)
+			mem=(size_t)strtoul(argv[i]+4,NULL,10)<<20;
+		else if (strncmp(argv[i],"tmp=",4)==0)
+			tmpdir=argv[i]+4;
+		else {
+			fprintf(stderr,"Unknown option %s\n",argv[i]);
+			return 1;
+		}
+	}
+	if (csr && strcmp(argv[2],"-")==0) {
+		fprintf(stderr,"A CSR file cannot be written to the standard output\n");
+		return 1;
+	}
+
+	t1=time(NULL);
+
+	canonicalize(argv[1],argv[2],csr,mem,tmpdir);
+
+	t2=time(NULL);
+
+	fprintf(stderr,"- Overall time = %ldh%ldm%lds\n",(t2-t1)/3600,((t2-t1)%3600)/60,((t2-t1)%60));
+
+	return 0;
+}
@@ -0,0 +1,202 @@
+/*
+Info:
+Feel free to use these lines as you wish. This program loads a graph once and runs several analyses on it, one after the other.
+The adjacency list is built (or the CSR file mapped) a single time and the analyses share it as well as their temporary arrays (see graph/analysis.c),
+instead of running bfs, diameter, triangle.exe, kcore.exe and pagerank.exe that would each parse the file again.
+
+To compile:
+"gcc cpa.c -O9 -o cpa -Igraph graph/libgraph.a -fopenmp -lz -lbz2 -lm" (after "make" in graph).
+
+To execute:
+"./cpa edgelist.txt [directed] [out=prefix] command1 command2 ...".
+"edgelist.txt" should contain the graph: one edge on each line (two unsigned long (nodes' ID)) separated by a space, or be a CSR file (see mkcsr.c).
+With "directed", edge (s,t) is only in the list of s (only pagerank and stats accept a directed graph).
+The commands are run in the given order:
+- stats: number of nodes and edges, degrees;
+- triangles: number of triangles, transitivity ratio and clustering coefficient;
+- kcore: core decomposition, largest core number;
+- pagerank: PageRank with teleportation probability 0.15, the 10 nodes of largest PageRank are printed;
+- diameter: exact diameter (largest distance over all the connected components) and radius of the largest component, with bounds
+  on the eccentricities as ./BFS-triangle/diameter (see graph/eccentricity.c).
+The summary of each analysis is printed in the terminal with its running time.
+With "out=prefix", the values of every node are also written in "prefix.triangles", "prefix.kcore" and "prefix.pagerank": one node on each line ("ID value"), or as raw arrays with GRAPH_OUTPUT=binary (see graph/output.c).
+
+Note:
+If the graph is directed (and weighted) with selfloops and you want to make it undirected unweighted without selfloops, use the canonicalizer of the root directory (parallel, and it also works on files larger than the memory).
+./canon.exe net.txt net2.txt
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <omp.h>
+
+#include "graph.h"
+
+#define PR_ALPHA 0.15
+#define PR_EPS 1e-9
+#define PR_MAXITER 100
+#define PR_TOP 10
+
+static const char *commands[]={"stats","triangles","kcore","pagerank","diameter",NULL};
+
+//values of every node in prefix.name, if an output prefix is given
+static void writeout(adjlist *g,char *prefix,char *name,const void *val,int type){
+	char path[4096];
+
+	if (prefix==NULL)
+		return;
+	snprintf(path,sizeof(path),"%s.%s",prefix,name);
+	writevalues(g,val,type,path);
+}
+
+static void run_stats(adjlist *g){
+	degstats st;
+
+	graphstats(g,&st);
+	printf("Number of nodes: %lu\n",g->n);
+	printf("Number of edges: %lu\n",g->e);
+	printf("Degree: min %lu, max %lu, average %f\n",st.mindeg,st.maxdeg,st.avgdeg);
+	printf("Nodes of degree 0: %lu\n",st.isolated);
+}
+
+static void run_triangles(adjlist *g,char *prefix){
+	unsigned long *t=malloc(g->n*sizeof(unsigned long)),u,nt,v=0,n2=0;
+	double cc=0;
+
+	nt=triangles(g,t);
+	for (u=0;u<g->n;u++) {
+		unsigned long d=g->cd[u+1]-g->cd[u];
+		v+=d*(d-1)/2;
+		if (d>=2) {
+			n2++;
+			cc+=(double)t[u]/(d*(d-1)/2);
+		}
+	}
+	printf("Number of triangles: %lu\n",nt);
+	printf("Number of V-edges: %lu\n",v);
+	printf("Transitivity ratio: %f\n",(v>0)?3.*nt/v:0);
+	printf("Clustering coefficient: %f\n",(n2>0)?cc/n2:0);
+
+	writeout(g,prefix,"triangles",t,VAL_U64);
+	free(t);
+}
+
+static void run_kcore(adjlist *g,scratch *s,char *prefix){
+	unsigned *core=malloc(g->n*sizeof(unsigned));
+	unsigned long u,k,size=0;
+
+	k=kcore(g,s,core);
+	for (u=0;u<g->n;u++)
+		if (core[u]==k)
+			size++;
+	printf("Largest core number: %lu\n",k);
+	printf("Nodes in the %lu-core: %lu\n",k,size);
+
+	writeout(g,prefix,"kcore",core,VAL_U32);
+	free(core);
+}
+
+static void run_pagerank(adjlist *g,scratch *s,char *prefix){
+	double *p=galloc(g->n*sizeof(double),"pagerank");
+	unsigned long top[PR_TOP],u;
+	unsigned iter;
+	int i,j,k=0;
+
+	iter=pagerank(g,s,PR_ALPHA,PR_EPS,PR_MAXITER,p);
+	printf("PageRank: %u iterations\n",iter);
+	for (u=0;u<g->n;u++) {//insertion in the sorted top list
+		if (k==PR_TOP && p[u]<=p[top[k-1]])
+			continue;
+		for (i=(k<PR_TOP)?k++:k-1;i>0 && p[top[i-1]]<p[u];i--)
+			top[i]=top[i-1];
+		top[i]=u;
+	}
+	for (j=0;j<k;j++)
+		printf("%lu %e\n",(unsigned long)nodeid(g,top[j]),p[top[j]]);
+
+	writeout(g,prefix,"pagerank",p,VAL_F64);
+	gfree(p);
+}
+
+static void run_diameter(adjlist *g){
+	unsigned dl,du,rl,ru;
+	unsigned long nbfs;
+
+	nbfs=diameter_radius(g,0,&dl,&du,&rl,&ru);
+	printf("Number of BFS: %lu\n",nbfs);
+	printf("Diameter: %u\n",dl);
+	printf("Radius of the largest component: %u\n",rl);
+}
+
+int main(int argc,char** argv){
+	adjlist* g;
+	scratch *s;
+	char *prefix=NULL;
+	int directed=0,i,j,first;
+	double t0,t1;
+
+	if (argc<3) {
+		fprintf(stderr,"Usage: %s edgelist.txt [directed] [out=prefix] command1 command2 ...\n",argv[0]);
+		fprintf(stderr,"Commands: stats triangles kcore pagerank diameter\n");
+		return 1;
+	}
+	//options, then the commands are checked before the graph is loaded
+	for (first=2;first<argc;first++) {
+		if (strcmp(argv[first],"directed")==0)
+			directed=1;
+		else if (strncmp(argv[first],"out=",4)==0)
+			prefix=argv[first]+4;
+		else
+			break;
+	}
+	for (i=first;i<argc;i++) {
+		for (j=0;commands[j]!=NULL && strcmp(argv[i],commands[j])!=0;j++);
+		if (commands[j]==NULL) {
+			fprintf(stderr,"Unknown command %s\n",argv[i]);
+			return 1;
+		}
+		if (directed && j!=0 && j!=3) {
+			fprintf(stderr,"%s needs an undirected graph\n",argv[i]);
+			return 1;
+		}
+	}
+
+	t0=omp_get_wtime();
+	printf("Reading graph from file %s\n",argv[1]);
+	g=loadadjlist(argv[1],directed);
+	if (directed && !(g->flags & GRAPH_DIRECTED)) {
+		fprintf(stderr,"The CSR file %s is undirected\n",argv[1]);
+		return 1;
+	}
+	s=mkscratch(g);
+	t1=omp_get_wtime();
+	printf("- Loading time = %fs\n",t1-t0);
+
+	for (i=first;i<argc;i++) {
+		printf("\n%s\n",argv[i]);
+		t0=omp_get_wtime();
+		if (strcmp(argv[i],"stats")==0)
+			run_stats(g);
+		else if (strcmp(argv[i],"triangles")==0) {
+			if (!(g->flags & GRAPH_SORTED)) {
+				printf("The lists of neighbors are not sorted, convert the CSR file again\n");
+				continue;
+			}
+			run_triangles(g,prefix);
+		}
+		else if (strcmp(argv[i],"kcore")==0)
+			run_kcore(g,s,prefix);
+		else if (strcmp(argv[i],"pagerank")==0)
+			run_pagerank(g,s,prefix);
+		else if (strcmp(argv[i],"diameter")==0)
+			run_diameter(g);
+		t1=omp_get_wtime();
+		printf("- %s time = %fs\n",argv[i],t1-t0);
+	}
+
+	free_scratch(s);
+	free_adjlist(g);
+
+	return 0;
+}
@@ -8,7 +8,7 @@ Info:
 Feel free to use these lines as you wish. This program loads a graph in main memory as a list of edges.
 
 To compile:
-"gcc edgelist.c -O9 -o edgelist".
+"gcc edgelist.c -O9 -o edgelist -Igraph graph/libgraph.a -fopenmp -lz -lbz2" (after "make" in graph).
 
 To execute:
 "./edgelist edgelist.txt".
@@ -16,8 +16,8 @@ To execute:
 The prograph loads the graph in main memory and then it terminates.
 
 Note:
-If the graph is directed (and weighted) with selfloops and you want to make it undirected unweighted without selfloops, use the following linux command line.
-awk '{if ($1<$2) print $1" "$2;else if ($2<$1) print $2" "$1}' net.txt | sort -n -k1,2 -u > net2.txt
+If the graph is directed (and weighted) with selfloops and you want to make it undirected unweighted without selfloops, use the canonicalizer of the root directory (parallel, and it also works on files larger than the memory).
+./canon.exe net.txt net2.txt
 
 Performance:
 Up to 500 million edges on my laptop with 8G of RAM:
@@ -28,56 +28,7 @@ Takes more or less 1.6G of RAM and 25 seconds (I have an SSD hardrive) for 100M
 #include <stdio.h>
 #include <time.h>//to estimate the runing time
 
-#define NLINKS 100000000 //maximum number of edges for memory allocation, will increase if needed
-
-typedef struct {
-	unsigned long s;
-	unsigned long t;
-} edge;
-
-//edge list structure:
-typedef struct {
-	unsigned long n;//number of nodes
-	unsigned long e;//number of edges
-	edge *edges;//list of edges
-} edgelist;
-
-//compute the maximum of three unsigned long
-inline unsigned long max3(unsigned long a,unsigned long b,unsigned long c){
-	a=(a>b) ? a : b;
-	return (a>c) ? a : c;
-}
-
-//reading the edgelist from file
-edgelist* readedgelist(char* input){
-	unsigned long e1=NLINKS;
-	FILE *file=fopen(input,"r");
-
-	edgelist *g=malloc(sizeof(edgelist));
-	g->n=0;
-	g->e=0;
-	g->edges=malloc(e1*sizeof(edge));//allocate some RAM to store edges
-
-	while (fscanf(file,"%lu %lu", &(g->edges[g->e].s), &(g->edges[g->e].t))==2) {
-		g->n=max3(g->n,g->edges[g->e].s,g->edges[g->e].t);
-		if (++(g->e)==e1) {//increase allocated RAM if needed
-			e1+=NLINKS;
-			g->edges=realloc(g->edges,e1*sizeof(edge));
-		}
-	}
-	fclose(file);
-
-	g->n++;
-
-	g->edges=realloc(g->edges,g->e*sizeof(edge));
-
-	return g;
-}
-
-void free_edgelist(edgelist *g){
-	free(g->edges);
-	free(g);
-}
+#include "graph.h"
 
 int main(int argc,char** argv){
 	edgelist* g;
@@ -0,0 +1,227 @@
+/*
+Info:
+Building the adjacency list (compressed sparse row format) from an edge list.
+
+How it works:
+All the passes are multithreaded with OpenMP: degrees are counted with atomic increments, cd is obtained with a parallel prefix sum,
+edges are scattered concurrently (each node has an atomic cursor in its list) and finally every list of neighbors is sorted.
+The scatter order depends on the scheduling, sorting the lists makes the result deterministic.
+Sorted lists allow merge-based intersections (triangles) and binary-search edge lookups (isedge).
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <omp.h>
+
+#include "graph.h"
+#include "internal.h"
+
+#define SMALLLIST 32 //lists shorter than that are sorted with insertion sort
+
+//cd[0]=0 and cd[i+1]=cd[i]+d[i], each thread sums one block of d then adds the total of the previous blocks
+//d and cd can be the same array
+void prefixsum(offset_t *d,offset_t *cd,unsigned long n){
+	int k=omp_get_max_threads();
+	offset_t *part=calloc(k+1,sizeof(offset_t));
+
+	#pragma omp parallel num_threads(k)
+	{
+		int id=omp_get_thread_num(),nt=omp_get_num_threads(),j;
+		unsigned long a=n*id/nt,b=n*(id+1)/nt,i;
+		offset_t s=0,x;
+
+		for (i=a;i<b;i++)
+			s+=d[i];
+		part[id+1]=s;
+		#pragma omp barrier
+		s=0;
+		for (j=0;j<=id;j++)
+			s+=part[j];
+		for (i=a;i<b;i++) {
+			x=d[i];
+			cd[i]=s;
+			s+=x;
+		}
+		if (id==nt-1)
+			cd[n]=s;
+	}
+	free(part);
+}
+
+static int cmpnode(const void *a,const void *b){
+	node_t x=*(const node_t*)a,y=*(const node_t*)b;
+	return (x>y)-(x<y);
+}
+
+//sorting a list of neighbors
+static void sortlist(node_t *l,unsigned long k){
+	unsigned long i,j;
+	node_t x;
+
+	if (k>SMALLLIST) {
+		qsort(l,k,sizeof(node_t),cmpnode);
+		return;
+	}
+	for (i=1;i<k;i++) {
+		x=l[i];
+		for (j=i;j>0 && l[j-1]>x;j--)
+			l[j]=l[j-1];
+		l[j]=x;
+	}
+}
+
+//sorting all the lists of neighbors, in parallel
+void sortlists(adjlist *g){
+	unsigned long u;
+
+	#pragma omp parallel for schedule(dynamic,1024)
+	for (u=0;u<g->n;u++)
+		sortlist(g->adj+g->cd[u],g->cd[u+1]-g->cd[u]);
+	g->flags|=GRAPH_SORTED;
+}
+
+//empty adjacency list structure (cd and adj are not allocated), re-executing the 64-bit build if adj does not fit in offset_t
+adjlist* newadjlist(unsigned long n,unsigned long e,int directed){
+	adjlist *g;
+
+	if ((directed ? e : 2*e)>OFFSET_MAX)
+		widen();
+
+	g=malloc(sizeof(adjlist));
+	g->n=n;
+	g->e=e;
+	g->cd=NULL;
+	g->adj=NULL;
+	g->zadj=NULL;
+	g->zcd=NULL;
+	g->ids=NULL;
+	g->byid=NULL;
+	g->flags=directed ? GRAPH_DIRECTED : 0;
+#ifdef GRAPH64
+	g->flags|=GRAPH_64;
+#endif
+	g->map=NULL;
+	g->mapsize=0;
+	return g;
+}
+
+//building the adjacency list, edge (s,t) is stored in the list of s and, if the graph is undirected, in the list of t
+static adjlist* build(edgelist* el,int directed){
+	unsigned long i;
+	node_t u,v;
+	offset_t p,*d;
+	adjlist *g=newadjlist(el->n,el->e,directed);
+
+	d=calloc(el->n,sizeof(offset_t));
+
+	#pragma omp parallel for private(u,v)
+	for (i=0;i<el->e;i++) {
+		u=el->edges[i].s;
+		v=el->edges[i].t;
+		#pragma omp atomic
+		d[u]++;
+		if (!directed) {
+			#pragma omp atomic
+			d[v]++;
+		}
+	}
+
+	g->cd=galloc((g->n+1)*sizeof(offset_t),"cd");
+	prefixsum(d,g->cd,g->n);
+
+	#pragma omp parallel for
+	for (i=0;i<g->n;i++)
+		d[i]=g->cd[i];//d is now the next free position in the list of each node
+
+	g->adj=galloc(g->cd[g->n]*sizeof(node_t),"adj");
+
+	#pragma omp parallel for private(u,v,p)
+	for (i=0;i<el->e;i++) {
+		u=el->edges[i].s;
+		v=el->edges[i].t;
+		#pragma omp atomic capture
+		p=d[u]++;
+		g->adj[p]=v;
+		if (!directed) {
+			#pragma omp atomic capture
+			p=d[v]++;
+			g->adj[p]=u;
+		}
+	}
+
+	free(d);
+
+	sortlists(g);
+
+	if (el->ids!=NULL) {
+		g->ids=malloc(g->n*sizeof(uint64_t));
+		memcpy(g->ids,el->ids,g->n*sizeof(uint64_t));
+		g->flags|=GRAPH_IDS;
+	}
+
+	return g;
+}
+
+//building the adjacency list, each edge is stored in the lists of its two nodes
+adjlist* mkadjlist(edgelist* el){
+	return build(el,0);
+}
+
+//building the adjacency list of a directed graph, edge (s,t) is only stored in the list of s
+adjlist* mkadjlist_directed(edgelist* el){
+	return build(el,1);
+}
+
+//1 if v is in the list of u, the lists have to be sorted
+int isedge(adjlist *g,unsigned long u,unsigned long v){
+	offset_t a=g->cd[u],b=g->cd[u+1],m;
+	nbriter it;
+	node_t w;
+
+	if (g->zadj!=NULL) {//compressed lists can only be read sequentially
+		forneighbors(g,u,w,it) {
+			if (w>=v)
+				return (w==v);
+		}
+		return 0;
+	}
+
+	while (a<b) {
+		m=a+(b-a)/2;
+		if (g->adj[m]<v)
+			a=m+1;
+		else
+			b=m;
+	}
+	return (a<g->cd[u+1] && g->adj[a]==v);
+}
+
+//freeing memory
+void free_adjlist(adjlist *g){
+	char *m=g->map;
+
+	free(g->byid);
+	if (m==NULL) {
+		gfree(g->cd);
+		gfree(g->adj);
+		gfree(g->zcd);
+		gfree(g->zadj);
+		free(g->ids);
+	}
+	else {//some arrays may have been copied out of the mapping
+		if ((char*)g->cd<m || (char*)g->cd>=m+g->mapsize)
+			gfree(g->cd);
+		if (g->adj!=NULL && ((char*)g->adj<m || (char*)g->adj>=m+g->mapsize))
+			gfree(g->adj);
+		if (g->zadj!=NULL && ((char*)g->zadj<m || (char*)g->zadj>=m+g->mapsize)) {
+			gfree(g->zcd);
+			gfree(g->zadj);
+		}
+		if (g->ids!=NULL && ((char*)g->ids<m || (char*)g->ids>=m+g->mapsize))
+			free(g->ids);
+		munmap(m,g->mapsize);
+	}
+	free(g);
+}
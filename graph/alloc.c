@@ -0,0 +1,264 @@
+/*
+Info:
+Allocation of the large arrays of the library (cd, adj, the compressed lists, BFS distances, PageRank vectors...) with a placement chosen at run time,
+so that the memory placement can be compared on NUMA servers without recompiling.
+
+The placement is read from the environment variable GRAPH_ALLOC, a comma-separated list of:
+- firsttouch: the pages are zeroed by all the threads (static schedule), so every page lands on the NUMA node of the thread that will
+  process this part of the array in the parallel loops;
+- interleave: the pages are spread round-robin over all the NUMA nodes (mbind MPOL_INTERLEAVE), which balances the bandwidth of
+  arrays accessed at random (adj during a BFS) over the sockets;
+- thp: transparent huge pages (2MB, madvise MADV_HUGEPAGE), fewer TLB misses on random accesses;
+- hugetlb: explicit 2MB huge pages (mmap MAP_HUGETLB, see /proc/sys/vm/nr_hugepages), thp is used when none is available;
+- report: when an array is freed (or at exit), its size, placement, amount of huge pages and pages per NUMA node are printed on stderr.
+Without GRAPH_ALLOC the arrays are allocated with calloc as before. Arrays smaller than GALLOC_MIN always use calloc.
+With a placement set, the arrays of a CSR file are copied out of the mapping into arrays allocated this way (see csrfile.c),
+as the pages of the page cache are on the node that read the file.
+TLB misses can then be compared with e.g. "perf stat -e dTLB-load-misses ./cpa graph.csr pagerank".
+
+galloc() returns zeroed memory and gfree() accepts the pointers of malloc too.
+*/
+
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <omp.h>
+
+#include "graph.h"
+
+#define GALLOC_MIN 2097152 //smaller arrays are malloc'ed
+#define HUGEPAGE 2097152
+#define MAXALLOC 256 //number of arrays followed at the same time, the next ones are malloc'ed
+#define MAXNODES 64 //NUMA nodes
+#define REPORTPAGES 4096 //pages sampled to find their NUMA node
+
+#define MPOL_INTERLEAVE_ 3
+#ifndef MAP_HUGE_2MB
+#define MAP_HUGE_2MB (21<<26)
+#endif
+
+#define GA_FIRSTTOUCH 1
+#define GA_INTERLEAVE 2
+#define GA_THP 4
+#define GA_HUGETLB 8
+#define GA_REPORT 16
+
+typedef struct {
+	void *p;//start of the array
+	void *base;//start of the mapping
+	size_t size,mapsize;
+	const char *name;
+	unsigned policy;//GA_* actually used
+} galloc_t;
+
+static galloc_t tab[MAXALLOC];
+static int ntab=0;
+static unsigned policy;
+static pthread_mutex_t lock=PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t once=PTHREAD_ONCE_INIT;
+
+static void report(galloc_t *a);
+
+static void reportall(void){
+	int i;
+	for (i=0;i<ntab;i++)
+		report(&tab[i]);
+}
+
+static void readpolicy(void){
+	char *env=getenv("GRAPH_ALLOC"),*s,*tok,*save;
+
+	policy=0;
+	if (env==NULL)
+		return;
+	s=strdup(env);
+	for (tok=strtok_r(s,",",&save);tok!=NULL;tok=strtok_r(NULL,",",&save)) {
+		if (strcmp(tok,"firsttouch")==0)
+			policy|=GA_FIRSTTOUCH;
+		else if (strcmp(tok,"interleave")==0)
+			policy|=GA_INTERLEAVE;
+		else if (strcmp(tok,"thp")==0)
+			policy|=GA_THP;
+		else if (strcmp(tok,"hugetlb")==0)
+			policy|=GA_HUGETLB;
+		else if (strcmp(tok,"report")==0)
+			policy|=GA_REPORT;
+		else
+			fprintf(stderr,"GRAPH_ALLOC: unknown placement %s (firsttouch, interleave, thp, hugetlb, report)\n",tok);
+	}
+	free(s);
+	if (policy & GA_REPORT)
+		atexit(reportall);
+}
+
+//1 if the arrays are not simply malloc'ed
+int allocpolicy(void){
+	pthread_once(&once,readpolicy);
+	return (policy & ~GA_REPORT)!=0;
+}
+
+//mask of the online NUMA nodes, returns the number of bits to give to mbind
+static unsigned long onlinenodes(unsigned long *mask){
+	FILE *file=fopen("/sys/devices/system/node/online","r");
+	unsigned long a,b,max=0;
+	char c;
+
+	*mask=1;
+	if (file==NULL)
+		return 2;
+	*mask=0;
+	while (fscanf(file,"%lu",&a)==1) {
+		b=a;
+		if (fscanf(file,"%c",&c)==1 && c=='-') {
+			if (fscanf(file,"%lu",&b)!=1)
+				b=a;
+			if (fscanf(file,"%c",&c)!=1)
+				c='\n';
+		}
+		for (;a<=b && a<MAXNODES;a++)
+			*mask|=1UL<<a;
+		if (b+1>max)
+			max=b+1;
+		if (c!=',')
+			break;
+	}
+	fclose(file);
+	if (*mask==0)
+		*mask=1;
+	return max+1;
+}
+
+//zeroed array of size bytes, name is used in the report
+void* galloc(size_t size,const char *name){
+	galloc_t a;
+	char *m;
+	size_t i;
+
+	allocpolicy();
+	if (policy==0 || size<GALLOC_MIN || ntab==MAXALLOC)
+		return calloc(size+1,1);
+
+	a.size=size;
+	a.name=name;
+	a.policy=policy;
+	a.base=MAP_FAILED;
+	if (policy & GA_HUGETLB) {
+		a.mapsize=(size+HUGEPAGE-1)/HUGEPAGE*HUGEPAGE;
+		a.base=mmap(NULL,a.mapsize,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS|MAP_HUGETLB|MAP_HUGE_2MB,-1,0);
+		if (a.base==MAP_FAILED)//no reserved huge pages
+			a.policy=(a.policy & ~GA_HUGETLB)|GA_THP;
+		a.p=a.base;
+	}
+	if (a.base==MAP_FAILED) {//aligned on 2MB so that whole huge pages can be used
+		a.mapsize=size+HUGEPAGE;
+		a.base=mmap(NULL,a.mapsize,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+		if (a.base==MAP_FAILED) {
+			fprintf(stderr,"Not enough memory for %s (%lu bytes)\n",name,(unsigned long)size);
+			exit(1);
+		}
+		a.p=(void*)(((uintptr_t)a.base+HUGEPAGE-1)/HUGEPAGE*HUGEPAGE);
+		if (a.policy & GA_THP)
+			madvise(a.p,size,MADV_HUGEPAGE);
+	}
+	if (a.policy & GA_INTERLEAVE) {
+		unsigned long mask,maxnode=onlinenodes(&mask);
+		if (syscall(SYS_mbind,a.p,size,MPOL_INTERLEAVE_,&mask,maxnode,0)!=0)
+			a.policy&=~GA_INTERLEAVE;
+	}
+	if (a.policy & GA_FIRSTTOUCH) {//the thread that will process a part of the array touches it first
+		m=a.p;
+		#pragma omp parallel for schedule(static)
+		for (i=0;i<size;i+=4096)
+			m[i]=0;
+	}
+
+	pthread_mutex_lock(&lock);
+	if (ntab<MAXALLOC)
+		tab[ntab++]=a;
+	else
+		a.p=NULL;
+	pthread_mutex_unlock(&lock);
+	if (a.p==NULL) {
+		munmap(a.base,a.mapsize);
+		return calloc(size+1,1);
+	}
+	return a.p;
+}
+
+void gfree(void *p){
+	galloc_t a;
+	int i,found=0;
+
+	if (p==NULL)
+		return;
+	pthread_mutex_lock(&lock);
+	for (i=0;i<ntab;i++)
+		if (tab[i].p==p) {
+			a=tab[i];
+			tab[i]=tab[--ntab];
+			found=1;
+			break;
+		}
+	pthread_mutex_unlock(&lock);
+	if (!found) {
+		free(p);
+		return;
+	}
+	if (policy & GA_REPORT)
+		report(&a);
+	munmap(a.base,a.mapsize);
+}
+
+//amount of huge pages of the mapping containing p (AnonHugePages of /proc/self/smaps, or its size if it uses hugetlb pages)
+static unsigned long hugebytes(galloc_t *a){
+	FILE *file;
+	char line[256];
+	unsigned long start,end,kb,total=0;
+	int in=0;
+
+	if (a->policy & GA_HUGETLB)
+		return a->size;
+	file=fopen("/proc/self/smaps","r");
+	if (file==NULL)
+		return 0;
+	while (fgets(line,sizeof(line),file)!=NULL) {
+		if (sscanf(line,"%lx-%lx ",&start,&end)==2 && strchr(line,'-')<strchr(line,' '))
+			in=(start<(uintptr_t)a->p+a->size && end>(uintptr_t)a->p);
+		else if (in && sscanf(line,"AnonHugePages: %lu kB",&kb)==1)
+			total+=kb*1024;
+	}
+	fclose(file);
+	return total;
+}
+
+static void report(galloc_t *a){
+	long ps=sysconf(_SC_PAGESIZE);
+	unsigned long np=(a->size+ps-1)/ps,step=(np+REPORTPAGES-1)/REPORTPAGES,i,k=0,count[MAXNODES+1];
+	void *pages[REPORTPAGES];
+	int status[REPORTPAGES],j;
+
+	memset(count,0,sizeof(count));
+	for (i=0;i<np;i+=step)
+		pages[k++]=(char*)a->p+i*ps;
+	if (syscall(SYS_move_pages,0,k,pages,NULL,status,0)!=0)
+		for (i=0;i<k;i++)
+			status[i]=-1;
+	for (i=0;i<k;i++)
+		count[(status[i]>=0 && status[i]<MAXNODES) ? status[i] : MAXNODES]++;
+
+	fprintf(stderr,"alloc %s: %.1fMB,%s%s%s%s%s, huge pages %.1fMB, pages per node:",a->name,a->size/1048576.,
+		(a->policy & ~GA_REPORT)==0 ? " default" : "",
+		(a->policy & GA_FIRSTTOUCH) ? " firsttouch" : "",(a->policy & GA_INTERLEAVE) ? " interleave" : "",
+		(a->policy & GA_THP) ? " thp" : "",(a->policy & GA_HUGETLB) ? " hugetlb" : "",hugebytes(a)/1048576.);
+	for (j=0;j<MAXNODES;j++)
+		if (count[j]>0)
+			fprintf(stderr," %d:%.0f%%",j,100.*count[j]/k);
+	if (count[MAXNODES]>0)
+		fprintf(stderr," not touched:%.0f%%",100.*count[MAXNODES]/k);
+	fprintf(stderr,"\n");
+}
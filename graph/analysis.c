@@ -0,0 +1,273 @@
+/*
+Info:
+Analyses of a loaded graph, run one after the other by cpa.c on the same adjacency list.
+The temporary arrays (distances, queues, counters, vectors of PageRank) are kept in a scratch structure:
+they are allocated by the first kernel that needs them and reused by the next ones, so a pipeline of analyses
+allocates and first-touches them once. The results are written in arrays given by the caller.
+
+Kernels:
+- graphstats: degree statistics;
+- triangles: number of triangles of every node, each triangle u<v<w is found once from its edge (u,v) by merging the sorted lists of u and v;
+- kcore: core number of every node with the bucket algorithm of Batagelj and Zaversnik (linear time);
+- pagerank: power iteration, pulling the scores of the neighbors on undirected graphs, pushing them (atomic additions) on directed ones,
+  the score of the nodes without out-neighbors is spread uniformly;
+- diameter_lb: lower bound on the diameter with repeated double sweeps (BFS from the farthest node of the previous BFS).
+triangles, kcore and diameter_lb expect an undirected graph, triangles also needs sorted lists.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <omp.h>
+
+#include "graph.h"
+
+static inline offset_t degree(adjlist *g,unsigned long u){
+	return g->cd[u+1]-g->cd[u];
+}
+
+static void* scratch_alloc(void **p,size_t size,const char *name){
+	if (*p==NULL)
+		*p=galloc(size,name);
+	return *p;
+}
+
+scratch* mkscratch(adjlist *g){
+	scratch *s=calloc(1,sizeof(scratch));
+	s->n=g->n;
+	return s;
+}
+
+void free_scratch(scratch *s){
+	gfree(s->dist);
+	gfree(s->queue);
+	gfree(s->cnt);
+	gfree(s->x);
+	gfree(s->y);
+	free(s);
+}
+
+void graphstats(adjlist *g,degstats *st){
+	unsigned long u,maxd=0,mind=-1,zero=0;
+
+	#pragma omp parallel for reduction(max:maxd) reduction(min:mind) reduction(+:zero)
+	for (u=0;u<g->n;u++) {
+		unsigned long d=degree(g,u);
+		if (d>maxd)
+			maxd=d;
+		if (d<mind)
+			mind=d;
+		if (d==0)
+			zero++;
+	}
+	st->maxdeg=maxd;
+	st->mindeg=(g->n>0)?mind:0;
+	st->isolated=zero;
+	st->avgdeg=(g->n>0)?(double)g->cd[g->n]/g->n:0;
+}
+
+//number of triangles of every node in t, returns the number of triangles of the graph
+unsigned long triangles(adjlist *g,unsigned long *t){
+	unsigned long u,total=0;
+
+	memset(t,0,g->n*sizeof(unsigned long));
+	#pragma omp parallel for reduction(+:total) schedule(dynamic,64)
+	for (u=0;u<g->n;u++) {
+		nbriter it,it1,it2;
+		node_t v,v1,v2;
+		int ok1,ok2;
+
+		forneighbors(g,u,v,it) {
+			if (v<=u)
+				continue;
+			//common neighbors w>v of u and v
+			nbr_begin(g,u,&it1);
+			nbr_begin(g,v,&it2);
+			ok1=nbr_next(&it1,&v1);
+			ok2=nbr_next(&it2,&v2);
+			while (ok1 && ok2) {
+				if (v1<v2)
+					ok1=nbr_next(&it1,&v1);
+				else if (v1>v2)
+					ok2=nbr_next(&it2,&v2);
+				else {
+					if (v1>v) {
+						#pragma omp atomic
+						t[u]++;
+						#pragma omp atomic
+						t[v]++;
+						#pragma omp atomic
+						t[v1]++;
+						total++;
+					}
+					ok1=nbr_next(&it1,&v1);
+					ok2=nbr_next(&it2,&v2);
+				}
+			}
+		}
+	}
+	return total;
+}
+
+//core number of every node in core, returns the largest one
+//vert is the list of nodes by increasing current degree, pos[u] the position of u in vert and bin[d] the first position of degree d
+unsigned long kcore(adjlist *g,scratch *s,unsigned *core){
+	node_t *vert=scratch_alloc((void**)&s->queue,g->n*sizeof(node_t),"queue"),v;
+	unsigned long *pos=scratch_alloc((void**)&s->cnt,(g->n+1)*sizeof(unsigned long),"cnt"),*bin;
+	unsigned long u,i,maxd=0,kmax=0;
+	nbriter it;
+
+	for (u=0;u<g->n;u++) {
+		core[u]=degree(g,u);
+		if (core[u]>maxd)
+			maxd=core[u];
+	}
+	bin=calloc(maxd+2,sizeof(unsigned long));
+	for (u=0;u<g->n;u++)
+		bin[core[u]+1]++;
+	for (i=0;i<=maxd;i++)
+		bin[i+1]+=bin[i];
+	for (u=0;u<g->n;u++) {
+		pos[u]=bin[core[u]]++;
+		vert[pos[u]]=u;
+	}
+	for (i=maxd;i>0;i--)//bin[d] is the start of degree d again
+		bin[i]=bin[i-1];
+	bin[0]=0;
+
+	for (i=0;i<g->n;i++) {
+		u=vert[i];
+		if (core[u]>kmax)
+			kmax=core[u];
+		forneighbors(g,u,v,it) {
+			if (core[v]>core[u]) {//v moves to the first position of its degree, then its degree decreases
+				unsigned dv=core[v];
+				unsigned long pw=bin[dv];
+				node_t w=vert[pw];
+				if (w!=v) {
+					vert[pos[v]]=w;
+					pos[w]=pos[v];
+					vert[pw]=v;
+					pos[v]=pw;
+				}
+				bin[dv]++;
+				core[v]--;
+			}
+		}
+	}
+
+	free(bin);
+	return kmax;
+}
+
+//PageRank of every node in p (sum 1), with teleportation probability alpha, until the L1 change is below eps or after maxiter iterations
+//returns the number of iterations
+unsigned pagerank(adjlist *g,scratch *s,double alpha,double eps,unsigned maxiter,double *p){
+	double *x=scratch_alloc((void**)&s->x,g->n*sizeof(double),"x");//score divided by the degree
+	double *y=scratch_alloc((void**)&s->y,g->n*sizeof(double),"y");//incoming score
+	unsigned long u,n=g->n;
+	unsigned iter;
+	int directed=(g->flags & GRAPH_DIRECTED)!=0;
+
+	if (n==0)
+		return 0;
+	#pragma omp parallel for
+	for (u=0;u<n;u++)
+		p[u]=1./n;
+
+	for (iter=1;iter<=maxiter;iter++) {
+		double dangling=0,diff=0;
+
+		#pragma omp parallel for reduction(+:dangling)
+		for (u=0;u<n;u++) {
+			if (degree(g,u)>0)
+				x[u]=p[u]/degree(g,u);
+			else {
+				x[u]=0;
+				dangling+=p[u];
+			}
+			y[u]=0;
+		}
+
+		if (directed) {
+			#pragma omp parallel for schedule(dynamic,1024)
+			for (u=0;u<n;u++) {
+				nbriter it;
+				node_t v;
+				if (x[u]==0)
+					continue;
+				forneighbors(g,u,v,it) {
+					#pragma omp atomic
+					y[v]+=x[u];
+				}
+			}
+		}
+		else {
+			#pragma omp parallel for schedule(dynamic,1024)
+			for (u=0;u<n;u++) {
+				nbriter it;
+				node_t v;
+				double sum=0;
+				forneighbors(g,u,v,it)
+					sum+=x[v];
+				y[u]=sum;
+			}
+		}
+
+		#pragma omp parallel for reduction(+:diff)
+		for (u=0;u<n;u++) {
+			double q=(1-alpha)*(y[u]+dangling/n)+alpha/n;
+			diff+=fabs(q-p[u]);
+			p[u]=q;
+		}
+		if (diff<eps)
+			break;
+	}
+	return (iter>maxiter)?maxiter:iter;
+}
+
+//BFS from u with the scratch arrays, returns the number of nodes reached, the last one being queue[result-1]
+static unsigned long sweep(adjlist *g,scratch *s,unsigned long u){
+	unsigned *dist=scratch_alloc((void**)&s->dist,g->n*sizeof(unsigned),"dist");
+	node_t *queue=scratch_alloc((void**)&s->queue,g->n*sizeof(node_t),"queue"),w;
+	unsigned long i,l=1;
+	nbriter it;
+
+	memset(dist,0xff,g->n*sizeof(unsigned));
+	queue[0]=u;
+	dist[u]=0;
+	for (i=0;i<l;i++) {
+		forneighbors(g,queue[i],w,it) {
+			if (dist[w]==(unsigned)-1) {
+				dist[w]=dist[queue[i]]+1;
+				queue[l++]=w;
+			}
+		}
+	}
+	return l;
+}
+
+//lower bound on the diameter: nsweeps double sweeps, the first one from the node of largest degree,
+//each one from the farthest node of the previous one
+unsigned diameter_lb(adjlist *g,scratch *s,unsigned nsweeps){
+	unsigned long u,l,best=0;
+	unsigned i,d,dmax=0;
+
+	if (g->n==0)
+		return 0;
+	for (u=1;u<g->n;u++)
+		if (degree(g,u)>degree(g,best))
+			best=u;
+	u=best;
+	for (i=0;i<2*nsweeps;i++) {
+		l=sweep(g,s,u);
+		u=s->queue[l-1];
+		d=s->dist[u];
+		if (d>dmax)
+			dmax=d;
+		else if (i%2==1)//no progress on this sweep
+			break;
+	}
+	return dmax;
+}
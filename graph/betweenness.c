@@ -0,0 +1,201 @@
+/*
+Info:
+Betweenness centrality, the graph is assumed to be undirected. The betweenness of v is the sum, over the unordered pairs {s,t} of nodes
+different from v, of the fraction of the shortest paths between s and t that go through v (the "unnormalized" value, divide it
+by (n-1)(n-2)/2 to get a fraction of the pairs).
+
+How it works:
+- betweenness: algorithm of Brandes ("A faster algorithm for betweenness centrality", 2001). From every source s, a BFS counts the
+  shortest paths sigma[v] from s to every node, then the nodes are taken by decreasing distance and the dependency
+  delta[v]=sum over the neighbors w of v one level farther of sigma[v]/sigma[w]*(1+delta[w]) is added to the betweenness of v.
+  The predecessors of w are its neighbors one level closer, so no list of predecessors is stored. The sources are shared by
+  the threads, each one with its own BFS workspace (bfsctx, the epoch stamps tell which entries of sigma and delta are set)
+  and its own array of betweenness, the arrays are summed at the end. Every pair is counted from both ends, hence the final 1/2.
+- betweenness_rk: sampling of Riondato and Kornaropoulos ("Fast approximation of betweenness centrality through sampling", WSDM 2014).
+  r pairs (s,t) are drawn uniformly, a BFS from s (stopped after the level of t) counts the shortest paths and one of them is
+  drawn uniformly by walking back from t (predecessor v of w chosen with probability sigma[v]/sigma[w]); each internal node of
+  the path gets 1/r. With r=(c/eps^2)(floor(log2(VD-2))+1+ln(1/delta)), where VD bounds the number of nodes of a shortest path
+  (twice the eccentricity of a node of each component, plus one), every estimated fraction is within eps of the exact one with
+  probability at least 1-delta. The estimates are scaled back to the unnormalized value.
+  The random generator of sample i is seeded from the seed and i, so that the estimates do not depend on the number of threads
+  nor on which thread draws which sample (every path adds the same amount, so the order of the additions does not matter either).
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <omp.h>
+
+#include "graph.h"
+
+#define RK_C 0.5 //universal constant of the sample size
+
+//BFS from s in x counting the shortest paths in sigma, stopped after the level of t if t<n
+//returns the number of nodes reached, listed by increasing distance in x->queue
+static unsigned long countpaths(adjlist *g,bfsctx *x,double *sigma,unsigned long s,unsigned long t){
+	unsigned *dist=x->dist,*stamp=x->stamp,e=bfsctx_next(x);
+	node_t *queue=x->queue,w;
+	unsigned long i,l=1;
+	nbriter it;
+
+	queue[0]=s;
+	stamp[s]=e;
+	dist[s]=0;
+	sigma[s]=1;
+	for (i=0;i<l;i++) {
+		node_t v=queue[i];
+		if (t<g->n && stamp[t]==e && dist[v]==dist[t])//the paths to t are all counted
+			break;
+		forneighbors(g,v,w,it) {
+			if (stamp[w]!=e) {
+				stamp[w]=e;
+				dist[w]=dist[v]+1;
+				sigma[w]=0;
+				queue[l++]=w;
+			}
+			if (dist[w]==dist[v]+1)
+				sigma[w]+=sigma[v];
+		}
+	}
+	x->len=l;
+	return l;
+}
+
+//exact betweenness of every node in bc
+void betweenness(adjlist *g,double *bc){
+	unsigned long n=g->n,u;
+
+	memset(bc,0,n*sizeof(double));
+	#pragma omp parallel
+	{
+		bfsctx *x=mkbfsctx(g);
+		double *sigma=galloc(n*sizeof(double),"sigma"),*delta=galloc(n*sizeof(double),"delta");
+		double *bcp=galloc(n*sizeof(double),"betweenness");//of this thread
+		unsigned long j;
+
+		#pragma omp for schedule(dynamic,16)
+		for (u=0;u<n;u++) {
+			unsigned long l=countpaths(g,x,sigma,u,n);
+			for (j=0;j<l;j++)
+				delta[x->queue[j]]=0;
+			for (j=l-1;j>0;j--) {//back-propagation by decreasing distance, the source is left out
+				node_t w=x->queue[j],v;
+				nbriter it;
+				double q=(1+delta[w])/sigma[w];
+				forneighbors(g,w,v,it)
+					if (x->dist[v]+1==x->dist[w] && x->stamp[v]==x->epoch)
+						delta[v]+=sigma[v]*q;
+				bcp[w]+=delta[w];
+			}
+		}
+
+		#pragma omp critical
+		{
+			for (j=0;j<n;j++)
+				bc[j]+=bcp[j]/2;
+		}
+		gfree(bcp);
+		gfree(sigma);
+		gfree(delta);
+		free_bfsctx(x);
+	}
+}
+
+//upper bound on the number of nodes of a shortest path: 2*eccentricity+1 of a node of each component, at most its size
+static unsigned long vertexdiameter(adjlist *g){
+	unsigned long n=g->n,u,j,l,vd=0,b;
+	unsigned char *done=calloc(n,1);
+	bfsctx *x=mkbfsctx(g);
+
+	for (u=0;u<n;u++) {
+		if (done[u])
+			continue;
+		l=bfs_ctx(g,x,u);
+		for (j=0;j<l;j++)
+			done[x->queue[j]]=1;
+		b=2*(unsigned long)x->dist[x->queue[l-1]]+1;
+		if (b>l)
+			b=l;
+		if (b>vd)
+			vd=b;
+	}
+	free_bfsctx(x);
+	free(done);
+	return vd;
+}
+
+//state of the random generator of sample i: the seed and i mixed by the finalizer of splitmix64
+static void sampleseed(unsigned short *xs,unsigned seed,unsigned long i){
+	uint64_t z=((uint64_t)seed<<32)+i+0x9e3779b97f4a7c15ULL;
+
+	z=(z^(z>>30))*0xbf58476d1ce4e5b9ULL;
+	z=(z^(z>>27))*0x94d049bb133111ebULL;
+	z^=z>>31;
+	xs[0]=z;
+	xs[1]=z>>16;
+	xs[2]=z>>32;
+}
+
+//number of samples needed for an error eps with probability 1-delta
+unsigned long rk_samples(adjlist *g,double eps,double delta){
+	unsigned long vd=vertexdiameter(g);
+	double logvd=(vd>3) ? floor(log2(vd-2)) : 0;
+
+	return (unsigned long)ceil(RK_C/(eps*eps)*(logvd+1+log(1/delta)));
+}
+
+//betweenness of every node in bc, estimated from r=rk_samples(g,eps,delta) shortest paths drawn uniformly, seed of the random generator
+//returns r
+unsigned long betweenness_rk(adjlist *g,double eps,double delta,unsigned seed,double *bc){
+	unsigned long n=g->n,r,i;
+	double scale;
+
+	memset(bc,0,n*sizeof(double));
+	if (n<3)
+		return 0;
+	r=rk_samples(g,eps,delta);
+	scale=(double)n*(n-1)/2/r;//a path counts for 1/r of the fraction of the pairs
+
+	#pragma omp parallel
+	{
+		bfsctx *x=mkbfsctx(g);
+		double *sigma=galloc(n*sizeof(double),"sigma");
+		unsigned short xs[3];
+
+		#pragma omp for schedule(dynamic,64)
+		for (i=0;i<r;i++) {
+			unsigned long s,t;
+			node_t w,v,p;
+			nbriter it;
+			sampleseed(xs,seed,i);
+			s=erand48(xs)*n;
+			t=erand48(xs)*(n-1);
+			if (t>=s)//t!=s
+				t++;
+			countpaths(g,x,sigma,s,t);
+			if (x->stamp[t]!=x->epoch)//no path
+				continue;
+			//walk back from t, each predecessor v of w with probability sigma[v]/sigma[w]
+			w=t;
+			while (x->dist[w]>1) {
+				double z=erand48(xs)*sigma[w];
+				p=w;
+				forneighbors(g,w,v,it) {
+					if (x->stamp[v]==x->epoch && x->dist[v]+1==x->dist[w]) {
+						p=v;
+						z-=sigma[v];
+						if (z<0)
+							break;
+					}
+				}
+				w=p;
+				#pragma omp atomic
+				bc[w]+=scale;
+			}
+		}
+		gfree(sigma);
+		free_bfsctx(x);
+	}
+	return r;
+}
@@ -0,0 +1,229 @@
+/*
+Info:
+Breadth-first search from one node, the graph is assumed to be undirected.
+
+How it works:
+Direction-optimizing BFS (Beamer, Asanovic and Patterson, SC 2012). Each level is built either:
+- top-down: the neighbors of every node of the frontier are scanned and the unvisited ones join the next level;
+- bottom-up: every unvisited node scans its neighbors and joins the next level as soon as one of them is in the frontier,
+  which is a bitmap of n bits; it stops at the first parent found, so on the large middle levels of small-world graphs
+  most of the edges are never looked at.
+The search goes bottom-up when the number of edges out of the frontier (mf) exceeds the number of edges out of the unvisited nodes (mu) divided by BFS_ALPHA,
+and goes back top-down when the frontier has less than n/BFS_BETA nodes. Directed graphs are always searched top-down (bottom-up needs the in-neighbors).
+The nodes are appended to the queue level by level in both directions, so the levels are consecutive ranges of the queue.
+
+Every level is expanded by all the threads: each thread appends the nodes it finds to its own queue, the queues are then copied
+one after the other after the current level (prefix sum of their lengths). Top-down, a node is claimed with a compare-and-swap on dist,
+so it is added by a single thread; bottom-up, every unvisited node is handled by one thread and needs no synchronization.
+The levels are synchronous, so the distances do not depend on the number of threads (only the order of the nodes within a level does).
+
+The direction, size and number of edges scanned of every level of the last search are given by bfs_levels().
+bfs() keeps its arrays between calls, so it must not be called by several threads at once.
+
+bfs_ctx() is the sequential top-down search on a workspace (bfsctx) owned by the caller, for running many searches in parallel
+(one per thread, see centralityPAR.c). The nodes are marked visited with the number of the search (epoch) instead of resetting dist:
+a search costs the nodes and edges it reaches, not n, and the stamps are cleared only when the epoch wraps around.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <omp.h>
+
+#include "graph.h"
+#include "internal.h"
+
+#define BFS_ALPHA 14
+#define BFS_BETA 24
+
+static bfslevel *levels=NULL;
+static unsigned nlevels=0,maxlevels=0;
+
+static void addlevel(unsigned long nodes,unsigned long edges,int bottomup){
+	if (nlevels==maxlevels) {
+		maxlevels=(maxlevels==0) ? 64 : 2*maxlevels;
+		levels=realloc(levels,maxlevels*sizeof(bfslevel));
+	}
+	levels[nlevels].nodes=nodes;
+	levels[nlevels].edges=edges;
+	levels[nlevels++].bottomup=bottomup;
+}
+
+//levels of the last search, returns their number
+unsigned bfs_levels(const bfslevel **l){
+	*l=levels;
+	return nlevels;
+}
+
+//distances from u to all nodes (-1 if not reachable)
+//the returned array is reused by the next call and must not be freed
+unsigned *bfs(adjlist *g,unsigned long u) {
+	unsigned long n=g->n,nw=n/64+1,a=0,b=1,l=1,i,mf,mu,edges;
+	unsigned d;
+	int bottomup=0,hybrid=!(g->flags & GRAPH_DIRECTED),t;
+
+	static unsigned *dist=NULL;
+	static node_t *list=NULL;
+	static uint64_t *front=NULL;
+	static localqueue *lq=NULL;
+	static int nt=0;
+
+	if (dist==NULL){
+		dist=galloc(n*sizeof(unsigned),"dist");
+		list=galloc(n*sizeof(node_t),"queue");//this will not be freed
+		front=galloc(nw*sizeof(uint64_t),"frontier");
+		nt=omp_get_max_threads();
+		lq=calloc(nt,sizeof(localqueue));
+	}
+
+	#pragma omp parallel for
+	for (i=0;i<n;i++) {
+		dist[i]=-1;
+	}
+
+	list[0]=u;
+
+	dist[u]=0;
+	nlevels=0;
+	addlevel(1,0,0);
+	mf=g->cd[u+1]-g->cd[u];
+	mu=g->cd[n]-mf;
+
+	//the current level is list[a..b-1], the next one is appended from l
+	for (d=1;a<b;d++) {
+		if (hybrid) {
+			if (!bottomup && mf>mu/BFS_ALPHA)
+				bottomup=1;
+			else if (bottomup && b-a<n/BFS_BETA)
+				bottomup=0;
+		}
+		if (bottomup) {
+			#pragma omp parallel for
+			for (i=0;i<nw;i++)
+				front[i]=0;
+			#pragma omp parallel for
+			for (i=a;i<b;i++) {
+				#pragma omp atomic
+				front[list[i]/64]|=(uint64_t)1<<(list[i]%64);
+			}
+		}
+
+		for (t=0;t<nt;t++)//the region may get fewer threads (nested call)
+			lq[t].len=lq[t].mf=lq[t].edges=0;
+		#pragma omp parallel num_threads(nt)
+		{
+			localqueue *q=lq+omp_get_thread_num();
+			unsigned long j,v;
+			nbriter it;
+			node_t w;
+
+			if (!bottomup) {
+				//the threads claim the unvisited neighbors with a compare-and-swap, so each node is added once
+				#pragma omp for schedule(dynamic,64) nowait
+				for (j=a;j<b;j++) {
+					v=list[j];
+					forneighbors(g,v,w,it) {
+						if (dist[w]==(unsigned)-1 && __sync_bool_compare_and_swap(&dist[w],(unsigned)-1,d)) {
+							lq_push(q,w);
+							q->mf+=g->cd[w+1]-g->cd[w];
+						}
+					}
+					q->edges+=g->cd[v+1]-g->cd[v];
+				}
+			}
+			else {
+				//every unvisited node belongs to one thread, it only looks for a parent in the frontier
+				#pragma omp for schedule(dynamic,1024) nowait
+				for (v=0;v<n;v++) {
+					if (dist[v]!=(unsigned)-1)
+						continue;
+					forneighbors(g,v,w,it) {
+						q->edges++;
+						if (front[w/64]>>(w%64) & 1) {
+							dist[v]=d;
+							lq_push(q,v);
+							q->mf+=g->cd[v+1]-g->cd[v];
+							break;
+						}
+					}
+				}
+			}
+		}
+
+		//concatenating the queues of the threads after the current level
+		mf=edges=0;
+		for (t=0;t<nt;t++) {
+			unsigned long len=lq[t].len;
+			lq[t].len=l;//position of the queue of t in list
+			l+=len;
+			mf+=lq[t].mf;
+			edges+=lq[t].edges;
+		}
+		#pragma omp parallel for num_threads(nt) schedule(static,1)
+		for (t=0;t<nt;t++) {
+			unsigned long next=(t+1<nt) ? lq[t+1].len : l;
+			memcpy(list+lq[t].len,lq[t].q,(next-lq[t].len)*sizeof(node_t));
+		}
+
+		mu-=mf;
+		a=b;
+		b=l;
+		if (a<b || edges>0)//the last level is empty
+			addlevel(b-a,edges,bottomup);
+	}
+
+	return dist;
+
+}
+
+bfsctx* mkbfsctx(adjlist *g){
+	bfsctx *c=malloc(sizeof(bfsctx));
+	c->n=g->n;
+	c->dist=galloc(g->n*sizeof(unsigned),"ctx dist");
+	c->stamp=galloc(g->n*sizeof(unsigned),"ctx stamp");
+	c->queue=galloc(g->n*sizeof(node_t),"ctx queue");
+	c->epoch=0;
+	c->len=0;
+	return c;
+}
+
+void free_bfsctx(bfsctx *c){
+	gfree(c->dist);
+	gfree(c->stamp);
+	gfree(c->queue);
+	free(c);
+}
+
+//starts a new search in c (nothing is stamped with the returned epoch yet)
+unsigned bfsctx_next(bfsctx *c){
+	if (++c->epoch==0) {//wrap around: the old stamps could be taken for the new epoch
+		memset(c->stamp,0,c->n*sizeof(unsigned));
+		c->epoch=1;
+	}
+	return c->epoch;
+}
+
+//distances from u in the workspace c (read them with bfsctx_dist), returns the number of nodes reached, listed in c->queue
+unsigned long bfs_ctx(adjlist *g,bfsctx *c,unsigned long u){
+	unsigned *dist=c->dist,*stamp=c->stamp,e;
+	node_t *queue=c->queue,w;
+	unsigned long i,l=1;
+	nbriter it;
+
+	e=bfsctx_next(c);
+	queue[0]=u;
+	stamp[u]=e;
+	dist[u]=0;
+	for (i=0;i<l;i++) {
+		node_t v=queue[i];
+		forneighbors(g,v,w,it) {
+			if (stamp[w]!=e) {
+				stamp[w]=e;
+				dist[w]=dist[v]+1;
+				queue[l++]=w;
+			}
+		}
+	}
+	c->len=l;
+	return l;
+}
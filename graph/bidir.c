@@ -0,0 +1,105 @@
+/*
+Info:
+Distance (and a shortest path) between two nodes, the graph is assumed to be undirected.
+
+How it works:
+Bidirectional BFS: a search from s and a search from t, each one in its own workspace (bfsctx), are expanded one level at a time,
+always the one whose frontier has the fewest edges to scan. When a level reaches a node already reached by the other search,
+the level is finished (a later neighbor of the same level can give a shorter path) and the distance is the smallest
+dist_s(v)+1+dist_t(w) over the edges (v,w) found between the two searches. On small-world graphs the two searches meet after
+about half the distance each, so a query scans a few thousand edges where a BFS from s scans the whole graph.
+The path is rebuilt from the meeting edge by walking back to s (and to t) along the nodes of distance one less, so no parent is stored.
+The workspaces are only written on the nodes the searches reach: one pair of workspaces per thread answers any number of queries.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "graph.h"
+
+//writes v and its predecessors towards the source of c at p, p+step, p+2*step...
+static void trace(adjlist *g,bfsctx *c,node_t v,node_t *p,long step){
+	unsigned d=c->dist[v];
+	nbriter it;
+	node_t w=v;
+
+	*p=v;
+	while (d>0) {
+		forneighbors(g,v,w,it)
+			if (c->stamp[w]==c->epoch && c->dist[w]==d-1)
+				break;
+		v=w;
+		d--;
+		p+=step;
+		*p=v;
+	}
+}
+
+//distance from s to t (-1 if t is not reachable) with the workspaces fw and bw,
+//if path is not NULL, the distance+1 nodes of a shortest path from s to t are written in it
+unsigned bidir_bfs(adjlist *g,bfsctx *fw,bfsctx *bw,unsigned long s,unsigned long t,node_t *path){
+	bfsctx *c[2]={fw,bw};
+	unsigned long a[2]={0,0},b[2]={1,1},mf[2];
+	unsigned e[2],best=-1;
+	node_t meet[2]={0,0};
+	int k;
+
+	if (s==t) {
+		if (path!=NULL)
+			path[0]=s;
+		return 0;
+	}
+	for (k=0;k<2;k++) {
+		unsigned long u=(k==0) ? s : t;
+		e[k]=bfsctx_next(c[k]);
+		c[k]->queue[0]=u;
+		c[k]->stamp[u]=e[k];
+		c[k]->dist[u]=0;
+		mf[k]=g->cd[u+1]-g->cd[u];
+	}
+
+	//the current level of search k is c[k]->queue[a[k]..b[k]-1]
+	while (best==(unsigned)-1 && a[0]<b[0] && a[1]<b[1]) {
+		bfsctx *x,*y;
+		unsigned long i,l;
+		unsigned ex,ey;
+
+		k=(mf[0]<=mf[1]) ? 0 : 1;
+		x=c[k];
+		y=c[1-k];
+		ex=e[k];
+		ey=e[1-k];
+		l=b[k];
+		mf[k]=0;
+		for (i=a[k];i<b[k];i++) {
+			node_t v=x->queue[i],w;
+			nbriter it;
+			forneighbors(g,v,w,it) {
+				if (y->stamp[w]==ey) {
+					unsigned d=x->dist[v]+1+y->dist[w];
+					if (d<best) {
+						best=d;
+						meet[k]=v;
+						meet[1-k]=w;
+					}
+				}
+				else if (x->stamp[w]!=ex) {
+					x->stamp[w]=ex;
+					x->dist[w]=x->dist[v]+1;
+					x->queue[l++]=w;
+					mf[k]+=g->cd[w+1]-g->cd[w];
+				}
+			}
+		}
+		a[k]=b[k];
+		b[k]=l;
+	}
+	fw->len=b[0];
+	bw->len=b[1];
+
+	if (best!=(unsigned)-1 && path!=NULL) {
+		trace(g,fw,meet[0],path+fw->dist[meet[0]],-1);
+		trace(g,bw,meet[1],path+fw->dist[meet[0]]+1,1);
+	}
+	return best;
+}
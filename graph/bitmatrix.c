@@ -0,0 +1,238 @@
+/*
+Info:
+Adjacency matrix stored as bitset rows: row u has one bit per node, packed in 64-bit words, so a graph takes n*n/8 bytes
+(8 times less than a matrix of bool) and the kernels on dense graphs work on 64 nodes per instruction or more.
+
+Row primitives:
+row_and, row_or and row_andnot combine whole rows, row_count and row_andcount count bits (popcount),
+row_intersects tells whether two rows share a bit and stops at the first common word.
+With AVX2 (compile with -mavx2 or -march=native) they process 256 bits per instruction and the popcount uses the nibble lookup of Mula et al.,
+otherwise they use 64-bit words and the popcount builtin (a single instruction with -mpopcnt), which gcc also vectorizes.
+Rows are 32-byte aligned and padded to a multiple of 4 words, the padding bits are always 0
+(the primitives expect such rows: w multiple of 4 and 32-byte aligned arrays).
+
+Kernels:
+triangles (sum over the edges of the size of the intersection of the rows), common neighbors of two nodes,
+and a BFS whose levels are bitsets: a node joins the next level if its row intersects the current level (bottom-up expansion).
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <omp.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "graph.h"
+
+#define ROWALIGN 4 //words per 256-bit vector
+
+//dst=a&b
+void row_and(uint64_t *dst,const uint64_t *a,const uint64_t *b,unsigned long w){
+	unsigned long i=0;
+#ifdef __AVX2__
+	for (;i<w;i+=4)
+		_mm256_store_si256((__m256i*)(dst+i),_mm256_and_si256(_mm256_load_si256((const __m256i*)(a+i)),_mm256_load_si256((const __m256i*)(b+i))));
+#endif
+	for (;i<w;i++)
+		dst[i]=a[i] & b[i];
+}
+
+//dst=a|b
+void row_or(uint64_t *dst,const uint64_t *a,const uint64_t *b,unsigned long w){
+	unsigned long i=0;
+#ifdef __AVX2__
+	for (;i<w;i+=4)
+		_mm256_store_si256((__m256i*)(dst+i),_mm256_or_si256(_mm256_load_si256((const __m256i*)(a+i)),_mm256_load_si256((const __m256i*)(b+i))));
+#endif
+	for (;i<w;i++)
+		dst[i]=a[i] | b[i];
+}
+
+//dst=a&~b
+void row_andnot(uint64_t *dst,const uint64_t *a,const uint64_t *b,unsigned long w){
+	unsigned long i=0;
+#ifdef __AVX2__
+	for (;i<w;i+=4)
+		_mm256_store_si256((__m256i*)(dst+i),_mm256_andnot_si256(_mm256_load_si256((const __m256i*)(b+i)),_mm256_load_si256((const __m256i*)(a+i))));
+#endif
+	for (;i<w;i++)
+		dst[i]=a[i] & ~b[i];
+}
+
+#ifdef __AVX2__
+//popcount of the 4 words of x, summed in 4 64-bit lanes
+static inline __m256i popcount256(__m256i x){
+	const __m256i table=_mm256_setr_epi8(0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4,0,1,1,2,1,2,2,3,1,2,2,3,2,3,3,4);
+	const __m256i low=_mm256_set1_epi8(0x0f);
+	__m256i c=_mm256_add_epi8(_mm256_shuffle_epi8(table,_mm256_and_si256(x,low)),_mm256_shuffle_epi8(table,_mm256_and_si256(_mm256_srli_epi16(x,4),low)));
+	return _mm256_sad_epu8(c,_mm256_setzero_si256());
+}
+
+static inline unsigned long hsum256(__m256i x){
+	return _mm256_extract_epi64(x,0)+_mm256_extract_epi64(x,1)+_mm256_extract_epi64(x,2)+_mm256_extract_epi64(x,3);
+}
+#endif
+
+//number of bits of a
+unsigned long row_count(const uint64_t *a,unsigned long w){
+	unsigned long i=0,c=0;
+#ifdef __AVX2__
+	__m256i s=_mm256_setzero_si256();
+	for (;i<w;i+=4)
+		s=_mm256_add_epi64(s,popcount256(_mm256_load_si256((const __m256i*)(a+i))));
+	c=hsum256(s);
+#endif
+	for (;i<w;i++)
+		c+=__builtin_popcountll(a[i]);
+	return c;
+}
+
+//number of bits of a&b
+unsigned long row_andcount(const uint64_t *a,const uint64_t *b,unsigned long w){
+	unsigned long i=0,c=0;
+#ifdef __AVX2__
+	__m256i s=_mm256_setzero_si256();
+	for (;i<w;i+=4)
+		s=_mm256_add_epi64(s,popcount256(_mm256_and_si256(_mm256_load_si256((const __m256i*)(a+i)),_mm256_load_si256((const __m256i*)(b+i)))));
+	c=hsum256(s);
+#endif
+	for (;i<w;i++)
+		c+=__builtin_popcountll(a[i] & b[i]);
+	return c;
+}
+
+//1 if a&b is not empty
+int row_intersects(const uint64_t *a,const uint64_t *b,unsigned long w){
+	unsigned long i=0;
+#ifdef __AVX2__
+	for (;i<w;i+=4)
+		if (!_mm256_testz_si256(_mm256_load_si256((const __m256i*)(a+i)),_mm256_load_si256((const __m256i*)(b+i))))
+			return 1;
+#endif
+	for (;i<w;i++)
+		if (a[i] & b[i])
+			return 1;
+	return 0;
+}
+
+//empty matrix of n nodes
+static bitmatrix* newbitmatrix(unsigned long n){
+	bitmatrix *m=malloc(sizeof(bitmatrix));
+	size_t size;
+
+	m->n=n;
+	m->e=0;
+	m->w=((n+63)/64+ROWALIGN-1)/ROWALIGN*ROWALIGN;
+	size=n*m->w*sizeof(uint64_t);
+	m->rows=aligned_alloc(32,size+32);
+	if (m->rows==NULL) {
+		fprintf(stderr,"Not enough memory for the adjacency matrix (%lu bytes)\n",(unsigned long)size);
+		exit(1);
+	}
+	memset(m->rows,0,size);
+	return m;
+}
+
+//building the bitset matrix of an undirected graph from an edge list, self-loops are ignored
+bitmatrix* mkbitmatrix(edgelist *el){
+	bitmatrix *m=newbitmatrix(el->n);
+	unsigned long i,e=0;
+
+	#pragma omp parallel for
+	for (i=0;i<el->e;i++) {
+		unsigned long u=el->edges[i].s,v=el->edges[i].t;
+		if (u==v)
+			continue;
+		#pragma omp atomic
+		m->rows[u*m->w+v/64]|=(uint64_t)1<<(v%64);
+		#pragma omp atomic
+		m->rows[v*m->w+u/64]|=(uint64_t)1<<(u%64);
+	}
+
+	//duplicated edges set the same bits, counting the edges from the rows
+	#pragma omp parallel for reduction(+:e) schedule(dynamic,256)
+	for (i=0;i<m->n;i++)
+		e+=row_count(bm_row(m,i),m->w);
+	m->e=e/2;
+
+	return m;
+}
+
+void free_bitmatrix(bitmatrix *m){
+	free(m->rows);
+	free(m);
+}
+
+//number of common neighbors of u and v
+unsigned long bm_common(bitmatrix *m,unsigned long u,unsigned long v){
+	return row_andcount(bm_row(m,u),bm_row(m,v),m->w);
+}
+
+//number of triangles: every edge (u,v) with u<v adds the size of the intersection of the rows, a triangle is seen by its 3 edges
+unsigned long bm_triangles(bitmatrix *m){
+	unsigned long u,t=0;
+
+	#pragma omp parallel for reduction(+:t) schedule(dynamic,64)
+	for (u=0;u<m->n;u++) {
+		const uint64_t *r=bm_row(m,u);
+		unsigned long i;
+		for (i=(u+1)/64;i<m->w;i++) {
+			uint64_t x=r[i];
+			if (i==(u+1)/64)//only the neighbors v>u
+				x&=~(uint64_t)0<<((u+1)%64);
+			while (x) {
+				t+=row_andcount(r,bm_row(m,64*i+__builtin_ctzll(x)),m->w);
+				x&=x-1;
+			}
+		}
+	}
+	return t/3;
+}
+
+//distances from u to all nodes (-1 if not reachable), the array has to be freed
+//every level is a bitset, an unvisited node joins the next level if its row intersects the current level
+unsigned *bm_bfs(bitmatrix *m,unsigned long u){
+	unsigned *dist=malloc(m->n*sizeof(unsigned));
+	uint64_t *front=aligned_alloc(32,m->w*sizeof(uint64_t)),*next=aligned_alloc(32,m->w*sizeof(uint64_t)),*seen=aligned_alloc(32,m->w*sizeof(uint64_t)),*tmp;
+	unsigned long i,size=1;
+	unsigned d;
+
+	for (i=0;i<m->n;i++)
+		dist[i]=-1;
+	memset(front,0,m->w*sizeof(uint64_t));
+	memset(seen,0,m->w*sizeof(uint64_t));
+	for (i=m->n;i<64*m->w;i++)//padding bits are never visited
+		seen[i/64]|=(uint64_t)1<<(i%64);
+	front[u/64]|=(uint64_t)1<<(u%64);
+	seen[u/64]|=(uint64_t)1<<(u%64);
+	dist[u]=0;
+
+	for (d=1;size>0;d++) {
+		size=0;
+		#pragma omp parallel for reduction(+:size) schedule(dynamic,16)
+		for (i=0;i<m->w;i++) {//each thread owns whole words of next
+			uint64_t x=~seen[i],y=0,b;
+			while (x) {
+				b=x & -x;
+				if (row_intersects(bm_row(m,64*i+__builtin_ctzll(x)),front,m->w)) {
+					y|=b;
+					dist[64*i+__builtin_ctzll(x)]=d;
+					size++;
+				}
+				x^=b;
+			}
+			next[i]=y;
+		}
+		row_or(seen,seen,next,m->w);
+		tmp=front;
+		front=next;
+		next=tmp;
+	}
+
+	free(front);
+	free(next);
+	free(seen);
+	return dist;
+}
@@ -0,0 +1,413 @@
+/*
+Info:
+Canonicalizing a text edge list: every edge is oriented (min,max), self-loops are dropped and duplicated edges are removed,
+the result is sorted by first then second node. This replaces "awk '{if ($1<$2) ...}' | sort -n -k1,2 -u" (see ../ex3).
+
+How it works:
+The text is mapped in memory and cut into segments whose edges fit in the memory budget (the newlines of the segment are counted first).
+The edges of a segment are parsed in parallel into packed keys, min<<32|max (a 64-bit key, or a 128-bit one in the 64-bit build),
+sorted with a parallel LSD radix sort (8 bits per pass, the passes where all the keys share the same byte are skipped) and deduplicated.
+If the whole file is a single segment the keys are written directly, otherwise each sorted segment is written to a temporary run file
+and the runs are merged with a heap (and deduplicated again) while writing the output.
+The output is a text edge list, or a CSR file (see csrfile.c) in which case the deduplicated edges have to fit in memory.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <omp.h>
+
+#include "graph.h"
+#include "internal.h"
+
+#ifdef GRAPH64
+typedef unsigned __int128 ekey;
+#define HALF 64
+#else
+typedef uint64_t ekey;
+#define HALF 32
+#endif
+
+#define KEYLOW(x) ((node_t)(x))
+#define KEYHIGH(x) ((node_t)((x)>>HALF))
+#define BLOCK 1048576 //granularity of the segments, in bytes of text
+#define RUNBUF 65536 //keys read at once from every run when merging
+#define OUTBUF 16777216 //size of the output buffers
+
+//start of the i-th of k chunks of the segment [a,b), aligned on the beginning of a line
+static size_t segchunk(const textfile *f,size_t a,size_t b,int i,int k){
+	size_t p;
+	if (i==0)
+		return a;
+	if (i==k)
+		return b;
+	p=a+(b-a)/k*i;
+	return (p==a) ? a : nextline(f->buf,b,p-1);
+}
+
+//parsing the segment [a,b) into keys, returns the number of keys
+static unsigned long parsesegment(textfile *f,size_t a,size_t b,ekey *key){
+	int k=omp_get_max_threads(),i;
+	unsigned long *ne=calloc(k+1,sizeof(unsigned long));
+	int wide=0;
+
+	//counting the edges of every chunk, then writing them at their position
+	#pragma omp parallel for schedule(dynamic,1) reduction(|:wide)
+	for (i=0;i<k;i++) {
+		size_t p=segchunk(f,a,b,i,k),end=segchunk(f,a,b,i+1,k);
+		unsigned long s,t;
+		int ok;
+
+		while (p<end) {
+			p=parseline(f->buf,end,p,&s,&t,&ok);
+			if (!ok || s==t)
+				continue;
+			if (s>NODE_MAX || t>NODE_MAX)
+				wide=1;
+			ne[i+1]++;
+		}
+	}
+	if (wide)
+		widen();
+	for (i=0;i<k;i++)
+		ne[i+1]+=ne[i];
+
+	#pragma omp parallel for schedule(dynamic,1)
+	for (i=0;i<k;i++) {
+		size_t p=segchunk(f,a,b,i,k),end=segchunk(f,a,b,i+1,k);
+		unsigned long s,t,j=ne[i];
+		int ok;
+
+		while (p<end) {
+			p=parseline(f->buf,end,p,&s,&t,&ok);
+			if (!ok || s==t)
+				continue;
+			key[j++]=(s<t) ? ((ekey)s<<HALF)|t : ((ekey)t<<HALF)|s;
+		}
+	}
+
+	a=ne[k];
+	free(ne);
+	return a;
+}
+
+//parallel LSD radix sort of key, using tmp of the same size, the result is in key
+static void radixsort(ekey *key,ekey *tmp,unsigned long n){
+	int k=omp_get_max_threads(),d;
+	unsigned long (*count)[256]=malloc(k*sizeof(*count));
+	ekey *t,*orig=key;
+
+	for (d=0;d<(int)sizeof(ekey);d++) {
+		int shift=8*d,skip=0;
+
+		#pragma omp parallel num_threads(k)
+		{
+			int id=omp_get_thread_num(),nt=omp_get_num_threads(),j,c;
+			unsigned long a=n*id/nt,b=n*(id+1)/nt,i,s;
+
+			memset(count[id],0,sizeof(*count));
+			for (i=a;i<b;i++)
+				count[id][(key[i]>>shift) & 255]++;
+			#pragma omp barrier
+			#pragma omp single
+			{
+				//position of the keys of digit c from thread j: keys of smaller digits, then of digit c from threads before j
+				s=0;
+				for (c=0;c<256;c++) {
+					unsigned long tot=0;
+					for (j=0;j<nt;j++) {
+						unsigned long x=count[j][c];
+						count[j][c]=s;
+						s+=x;
+						tot+=x;
+					}
+					if (tot==n)//all the keys have the same digit
+						skip=1;
+				}
+			}
+			if (!skip) {
+				for (i=a;i<b;i++)
+					tmp[count[id][(key[i]>>shift) & 255]++]=key[i];
+			}
+		}
+		if (!skip) {
+			t=key;
+			key=tmp;
+			tmp=t;
+		}
+	}
+	if (key!=orig)//odd number of passes
+		memcpy(orig,key,n*sizeof(ekey));
+	free(count);
+}
+
+//removing duplicated keys of a sorted array, returns the new length
+static unsigned long uniquekeys(ekey *key,unsigned long n){
+	unsigned long i,j=0;
+
+	for (i=0;i<n;i++)
+		if (j==0 || key[i]!=key[j-1])
+			key[j++]=key[i];
+	return j;
+}
+
+//writing the keys as text lines, formatted in parallel by blocks and written in order
+static void writekeys(FILE *out,ekey *key,unsigned long n){
+	unsigned long blk=OUTBUF/48,a;
+	int k=omp_get_max_threads();
+	char **buf=malloc(k*sizeof(char*));
+	size_t *len=malloc(k*sizeof(size_t));
+	int i;
+
+	for (i=0;i<k;i++)
+		buf[i]=malloc(OUTBUF);
+	for (a=0;a<n;a+=k*blk) {
+		#pragma omp parallel for schedule(static,1)
+		for (i=0;i<k;i++) {
+			unsigned long j,b=a+i*blk,e=b+blk;
+			char *p=buf[i];
+			if (e>n)
+				e=n;
+			for (j=b;j<e;j++) {
+				p=putulong(p,KEYHIGH(key[j]));
+				*(p++)=' ';
+				p=putulong(p,KEYLOW(key[j]));
+				*(p++)='\n';
+			}
+			len[i]=(b<e) ? p-buf[i] : 0;
+		}
+		for (i=0;i<k;i++)
+			if (len[i]>0 && fwrite(buf[i],1,len[i],out)!=len[i]) {
+				fprintf(stderr,"Error while writing the output\n");
+				exit(1);
+			}
+	}
+	for (i=0;i<k;i++)
+		free(buf[i]);
+	free(buf);
+	free(len);
+}
+
+//edge list of the sorted distinct keys
+static edgelist* keystoedges(ekey *key,unsigned long n){
+	edgelist *el=malloc(sizeof(edgelist));
+	unsigned long i;
+
+	el->e=n;
+	el->edges=malloc(n*sizeof(edge)+1);
+	el->ids=NULL;
+	el->n=0;
+	#pragma omp parallel for
+	for (i=0;i<n;i++) {
+		el->edges[i].s=KEYHIGH(key[i]);
+		el->edges[i].t=KEYLOW(key[i]);
+	}
+	compact_edgelist(el);
+	return el;
+}
+
+//sorted run of keys in a temporary file
+typedef struct {
+	FILE *file;
+	ekey *buf;
+	unsigned long len,pos;
+} run;
+
+static int nextkey(run *r,ekey *x){
+	if (r->pos==r->len) {
+		r->len=fread(r->buf,sizeof(ekey),RUNBUF,r->file);
+		r->pos=0;
+		if (r->len==0)
+			return 0;
+	}
+	*x=r->buf[r->pos++];
+	return 1;
+}
+
+//min-heap of the runs by their current key
+static void siftdown(int *heap,ekey *cur,int size,int i){
+	int c,x=heap[i];
+
+	while ((c=2*i+1)<size) {
+		if (c+1<size && cur[heap[c+1]]<cur[heap[c]])
+			c++;
+		if (cur[heap[c]]>=cur[x])
+			break;
+		heap[i]=heap[c];
+		i=c;
+	}
+	heap[i]=x;
+}
+
+//canonicalizing the edge list input into output (text, or CSR if csr is 1), mem is the memory budget for the keys in bytes
+//the sorted runs are written in the directory tmpdir when the input does not fit in the budget
+void canonicalize(char *input,char *output,int csr,size_t mem,char *tmpdir){
+	textfile f;
+	unsigned long nb,b,cap,lines,maxlines,n,m=0,nruns=0,i;
+	unsigned long *nl;
+	size_t *seg;
+	ekey *key,*tmp;
+	run *runs=NULL;
+	edgelist *el=NULL;
+	FILE *out=NULL;
+
+	openfile(input,&f);
+
+	//number of lines of every block, to cut segments that fit in the budget
+	nb=f.len/BLOCK+1;
+	nl=calloc(nb,sizeof(unsigned long));
+	#pragma omp parallel for schedule(dynamic,1)
+	for (b=0;b<nb;b++) {
+		const char *p=f.buf+b*BLOCK,*end=f.buf+((b+1)*BLOCK<f.len ? (b+1)*BLOCK : f.len);
+		while (p<end && (p=memchr(p,'\n',end-p))!=NULL) {
+			nl[b]++;
+			p++;
+		}
+	}
+	cap=mem/(2*sizeof(ekey));
+	if (cap<BLOCK)
+		cap=BLOCK;
+	seg=malloc((nb+1)*sizeof(size_t));
+	seg[0]=0;
+	lines=0;
+	maxlines=0;
+	for (b=0;b<nb;b++) {
+		if (lines+nl[b]>cap && lines>0 && nextline(f.buf,f.len,b*BLOCK-1)>seg[m]) {//the segment ends with the line that crosses the block boundary
+			seg[++m]=nextline(f.buf,f.len,b*BLOCK-1);
+			lines=0;
+		}
+		lines+=nl[b]+1;//a segment has at most one line more than its newlines
+		if (lines>maxlines)
+			maxlines=lines;
+	}
+	seg[++m]=f.len;
+	free(nl);
+
+	if (strcmp(output,"-")==0)
+		out=stdout;
+	else if (!csr && (out=fopen(output,"w"))==NULL) {
+		fprintf(stderr,"Cannot write %s\n",output);
+		exit(1);
+	}
+
+	key=malloc((maxlines+1)*sizeof(ekey));
+	tmp=malloc((maxlines+1)*sizeof(ekey));
+
+	for (i=0;i<m;i++) {
+		n=parsesegment(&f,seg[i],seg[i+1],key);
+		radixsort(key,tmp,n);
+		n=uniquekeys(key,n);
+		if (m==1) {//everything fits in memory
+			if (csr)
+				el=keystoedges(key,n);
+			else
+				writekeys(out,key,n);
+			break;
+		}
+		runs=realloc(runs,(nruns+1)*sizeof(run));
+		runs[nruns].file=NULL;
+		{
+			char name[4096];
+			int fd;
+			snprintf(name,sizeof(name),"%s/canon-XXXXXX",tmpdir);
+			fd=mkstemp(name);
+			if (fd<0 || (runs[nruns].file=fdopen(fd,"w+"))==NULL) {
+				fprintf(stderr,"Cannot create a temporary file in %s\n",tmpdir);
+				exit(1);
+			}
+			unlink(name);//removed when closed
+		}
+		if (fwrite(key,sizeof(ekey),n,runs[nruns].file)!=n) {
+			fprintf(stderr,"Error while writing a temporary file in %s\n",tmpdir);
+			exit(1);
+		}
+		rewind(runs[nruns].file);
+		nruns++;
+	}
+	closefile(&f);
+	free(seg);
+
+	if (nruns>0) {//merging the runs
+		int *heap=malloc(nruns*sizeof(int)),size=0,r;
+		ekey *cur=malloc(nruns*sizeof(ekey)),last=0;
+		unsigned long ne=0,kcap=0;
+		char *buf=NULL,*p=NULL;
+		int first=1;
+
+		free(tmp);
+		tmp=NULL;
+		if (csr) {
+			free(key);
+			key=NULL;
+		}
+		else {
+			buf=(char*)key;//the key array becomes the output buffer
+			p=buf;
+		}
+		for (r=0;r<(int)nruns;r++) {
+			runs[r].buf=malloc(RUNBUF*sizeof(ekey));
+			runs[r].len=runs[r].pos=0;
+			if (nextkey(runs+r,cur+r))
+				heap[size++]=r;
+		}
+		for (r=size/2-1;r>=0;r--)
+			siftdown(heap,cur,size,r);
+		while (size>0) {
+			ekey x=cur[heap[0]];
+			if (first || x!=last) {
+				if (csr) {
+					if (ne==kcap) {
+						kcap=2*kcap+RUNBUF;
+						key=realloc(key,kcap*sizeof(ekey));
+					}
+					key[ne++]=x;
+				}
+				else {
+					p=putulong(p,KEYHIGH(x));
+					*(p++)=' ';
+					p=putulong(p,KEYLOW(x));
+					*(p++)='\n';
+					if (p-buf>(long)((maxlines+1)*sizeof(ekey))-48) {
+						if (fwrite(buf,1,p-buf,out)!=(size_t)(p-buf)) {
+							fprintf(stderr,"Error while writing the output\n");
+							exit(1);
+						}
+						p=buf;
+					}
+				}
+				last=x;
+				first=0;
+			}
+			if (!nextkey(runs+heap[0],cur+heap[0]))
+				heap[0]=heap[--size];
+			siftdown(heap,cur,size,0);
+		}
+		if (!csr && p>buf && fwrite(buf,1,p-buf,out)!=(size_t)(p-buf)) {
+			fprintf(stderr,"Error while writing the output\n");
+			exit(1);
+		}
+		if (csr)
+			el=keystoedges(key,ne);
+		for (r=0;r<(int)nruns;r++) {
+			fclose(runs[r].file);
+			free(runs[r].buf);
+		}
+		free(runs);
+		free(heap);
+		free(cur);
+	}
+	free(key);
+	free(tmp);
+
+	if (csr) {
+		adjlist *g=mkadjlist(el);
+		free_edgelist(el);
+		writecsr(g,output);
+		free_adjlist(g);
+	}
+	else if (out!=stdout)
+		fclose(out);
+	else
+		fflush(out);
+}
@@ -0,0 +1,128 @@
+/*
+Info:
+Connected components (weakly connected ones if the graph is directed), on all the cores in near-linear time.
+
+How it works:
+Afforest (Sutton, Ben-Nun and Barak, "Optimizing parallel graph connectivity computation via subgraph sampling", IPDPS 2018).
+comp[] is a forest where every node points to a node of smaller ID, the root of a tree being its smallest node; two trees are
+linked by a compare-and-swap of the root of larger ID towards the other one (lock-free union-find), and compress() points every
+node to its root.
+- The first CC_ROUNDS neighbors of every node are linked first (a sparse subgraph with the same large component, most of the time);
+- the ID of the component of the largest part of the nodes is then estimated from CC_SAMPLES random nodes;
+- the remaining neighbors are linked, except for the nodes already in that component: on an undirected graph every edge is in the
+  lists of its two ends, so the edges leaving the large component are still linked from their other end. Most of the edges of the
+  largest component are thus never looked at. A directed graph has each edge once, so all of them are linked.
+At the end comp[u] is the smallest node of the component of u.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <omp.h>
+
+#include "graph.h"
+
+#define CC_ROUNDS 2
+#define CC_SAMPLES 1024
+
+static void unite(node_t u,node_t v,node_t *comp){
+	node_t p1=comp[u],p2=comp[v],high,low,ph;
+
+	while (p1!=p2) {
+		high=(p1>p2)?p1:p2;
+		low=p1+p2-high;
+		ph=comp[high];
+		if (ph==low)//already linked
+			break;
+		if (ph==high && __sync_bool_compare_and_swap(comp+high,high,low))
+			break;
+		p1=comp[comp[high]];
+		p2=comp[low];
+	}
+}
+
+static void compress(unsigned long n,node_t *comp){
+	unsigned long u;
+
+	#pragma omp parallel for schedule(dynamic,16384)
+	for (u=0;u<n;u++)
+		while (comp[u]!=comp[comp[u]])
+			comp[u]=comp[comp[u]];
+}
+
+//most frequent component among CC_SAMPLES random nodes
+static node_t frequent(unsigned long n,node_t *comp){
+	node_t *s=malloc(CC_SAMPLES*sizeof(node_t)),best=comp[0];
+	unsigned long seed=1,i,j,run,bestrun=0;
+
+	for (i=0;i<CC_SAMPLES;i++) {
+		seed=seed*6364136223846793005UL+1442695040888963407UL;
+		s[i]=comp[(seed>>33)%n];
+	}
+	//insertion sort is enough for 1024 values
+	for (i=1;i<CC_SAMPLES;i++) {
+		node_t x=s[i];
+		for (j=i;j>0 && s[j-1]>x;j--)
+			s[j]=s[j-1];
+		s[j]=x;
+	}
+	for (i=0;i<CC_SAMPLES;i=j) {
+		for (j=i;j<CC_SAMPLES && s[j]==s[i];j++);
+		run=j-i;
+		if (run>bestrun) {
+			bestrun=run;
+			best=s[i];
+		}
+	}
+	free(s);
+	return best;
+}
+
+//component of every node in comp (its smallest node), returns the number of components
+unsigned long connected_components(adjlist *g,node_t *comp){
+	unsigned long n=g->n,u,nc=0;
+	int r,directed=(g->flags & GRAPH_DIRECTED)!=0;
+	node_t c;
+
+	if (n==0)
+		return 0;
+	#pragma omp parallel for
+	for (u=0;u<n;u++)
+		comp[u]=u;
+
+	for (r=0;r<CC_ROUNDS;r++) {
+		#pragma omp parallel for schedule(dynamic,16384)
+		for (u=0;u<n;u++) {
+			nbriter it;
+			node_t v;
+			int i=0;
+			forneighbors(g,u,v,it) {
+				if (i++==r) {
+					unite(u,v,comp);
+					break;
+				}
+			}
+		}
+		compress(n,comp);
+	}
+
+	c=frequent(n,comp);
+	#pragma omp parallel for schedule(dynamic,16384)
+	for (u=0;u<n;u++) {
+		nbriter it;
+		node_t v;
+		int i=0;
+		if (!directed && comp[u]==c)
+			continue;
+		forneighbors(g,u,v,it)
+			if (i++>=CC_ROUNDS)
+				unite(u,v,comp);
+	}
+	compress(n,comp);
+
+	#pragma omp parallel for reduction(+:nc)
+	for (u=0;u<n;u++)
+		if (comp[u]==u)
+			nc++;
+	return nc;
+}
@@ -0,0 +1,185 @@
+/*
+Info:
+Exact closeness and harmonic centrality, the graph is assumed to be undirected.
+With r(v) the number of nodes of the connected component of v and f(v) the sum of the distances from v to them (farness):
+- closeness(v)=(r(v)-1)^2/((n-1)*f(v)) (Wasserman and Faust), which is (n-1)/f(v) on a connected graph and stays meaningful otherwise;
+- harmonic(v)=sum of 1/d(v,w) over the nodes w!=v reachable from v, divided by n-1.
+
+How it works:
+- closeness: one BFS from every node, the sources are shared by the threads (dynamic schedule), each one searching in its own
+  workspace (bfsctx, see bfs.c) so a search costs only the component it explores;
+- closeness_topk: the k nodes of largest centrality with the pruned BFS of Bergamini, Borassi, Crescenzi, Marino and Meyerhenke
+  ("Computing top-k closeness centrality faster in unweighted graphs", ALENEX 2016). The nodes are searched by decreasing degree.
+  Before expanding level d+1 of the BFS from v, the nodes at distance at most d are known; the next level has at most
+  x=min(rem,sum of deg(w)-1 over the level d) of the rem nodes left in the component and the others are at distance d+2 or more, so
+  f(v)>=S+(d+1)x+(d+2)(rem-x), which bounds the centrality of v from above. The search stops as soon as this bound is below
+  the k-th best exact value found so far: on small-world graphs most searches stop after a few levels.
+  The component sizes are computed first (one BFS per component). The k-th value is shared by the threads and only grows,
+  a thread reading an old one just prunes less, so the result does not depend on the number of threads (up to ties).
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <omp.h>
+
+#include "graph.h"
+
+static inline offset_t degree(adjlist *g,unsigned long u){
+	return g->cd[u+1]-g->cd[u];
+}
+
+static double value(unsigned long n,unsigned long r,unsigned long f,double h,int harmonic){
+	if (n<2)
+		return 0;
+	if (harmonic)
+		return h/(n-1);
+	if (f==0)
+		return 0;
+	return (double)(r-1)*(r-1)/((double)(n-1)*f);
+}
+
+//closeness (harmonic=0) or harmonic centrality (harmonic=1) of every node in c
+void closeness(adjlist *g,int harmonic,double *c){
+	unsigned long n=g->n,u;
+
+	#pragma omp parallel
+	{
+		bfsctx *x=mkbfsctx(g);
+
+		#pragma omp for schedule(dynamic,16)
+		for (u=0;u<n;u++) {
+			unsigned long j,l=bfs_ctx(g,x,u),f=0;
+			double h=0;
+			for (j=1;j<l;j++) {
+				unsigned d=x->dist[x->queue[j]];
+				f+=d;
+				h+=1./d;
+			}
+			c[u]=value(n,l,f,h,harmonic);
+		}
+		free_bfsctx(x);
+	}
+}
+
+//size of the component of every node in r
+static void compsizes(adjlist *g,bfsctx *x,unsigned *r){
+	unsigned long u,j,l;
+
+	for (u=0;u<g->n;u++)
+		r[u]=0;
+	for (u=0;u<g->n;u++) {
+		if (r[u]!=0)
+			continue;
+		l=bfs_ctx(g,x,u);
+		for (j=0;j<l;j++)
+			r[x->queue[j]]=l;
+	}
+}
+
+//BFS from u stopped as soon as the centrality of u is provably at most *kth, returns its centrality or -1 if stopped
+static double pruned(adjlist *g,bfsctx *x,unsigned long u,unsigned long r,int harmonic,volatile double *kth,unsigned long *edges){
+	unsigned *dist=x->dist,*stamp=x->stamp,e=bfsctx_next(x),d;
+	node_t *queue=x->queue,w;
+	unsigned long n=g->n,a=0,b=1,l=1,i,f=0,next=degree(g,u),rem,y;
+	double h=0,ub;
+	nbriter it;
+
+	queue[0]=u;
+	stamp[u]=e;
+	dist[u]=0;
+	//the level d is queue[a..b-1], next bounds the number of nodes at distance d+1
+	for (d=0;a<b;d++) {
+		rem=r-b;
+		y=(next<rem) ? next : rem;
+		if (harmonic)
+			ub=value(n,r,0,h+(double)y/(d+1)+(double)(rem-y)/(d+2),1);
+		else
+			ub=value(n,r,f+(unsigned long)(d+1)*y+(unsigned long)(d+2)*(rem-y),0,0);
+		if (ub<*kth) {
+			x->len=l;
+			return -1;
+		}
+		next=0;
+		for (i=a;i<b;i++) {
+			node_t v=queue[i];
+			*edges+=degree(g,v);
+			forneighbors(g,v,w,it) {
+				if (stamp[w]!=e) {
+					stamp[w]=e;
+					dist[w]=d+1;
+					queue[l++]=w;
+					f+=d+1;
+					h+=1./(d+1);
+					next+=degree(g,w)-1;
+				}
+			}
+		}
+		a=b;
+		b=l;
+	}
+	x->len=l;
+	return value(n,r,f,h,harmonic);
+}
+
+//the k nodes of largest closeness (harmonic=0) or harmonic centrality (harmonic=1) in top and their values in val, by decreasing value
+//returns the number of edges scanned by the pruned searches
+unsigned long closeness_topk(adjlist *g,int harmonic,unsigned k,node_t *top,double *val){
+	unsigned long n=g->n,u,i,maxd=0,edges=0,*bin;
+	unsigned *r=galloc(n*sizeof(unsigned),"component size");
+	node_t *order=galloc(n*sizeof(node_t),"order");
+	volatile double kth=-1;
+	unsigned nt=0;
+	bfsctx *x;
+
+	if (k>n)
+		k=n;
+	x=mkbfsctx(g);
+	compsizes(g,x,r);
+	free_bfsctx(x);
+
+	//nodes by decreasing degree (counting sort)
+	for (u=0;u<n;u++)
+		if (degree(g,u)>maxd)
+			maxd=degree(g,u);
+	bin=calloc(maxd+2,sizeof(unsigned long));
+	for (u=0;u<n;u++)
+		bin[maxd-degree(g,u)+1]++;
+	for (i=0;i<=maxd;i++)
+		bin[i+1]+=bin[i];
+	for (u=0;u<n;u++)
+		order[bin[maxd-degree(g,u)]++]=u;
+	free(bin);
+
+	#pragma omp parallel reduction(+:edges)
+	{
+		bfsctx *x=mkbfsctx(g);
+
+		#pragma omp for schedule(dynamic,1)
+		for (i=0;i<n;i++) {
+			unsigned long v=order[i];
+			unsigned j;
+			double c=pruned(g,x,v,r[v],harmonic,&kth,&edges);
+			if (c<0 || c<kth)
+				continue;
+			#pragma omp critical
+			{
+				if (nt<k || c>val[nt-1]) {//insertion in the sorted top list
+					for (j=(nt<k)?nt++:nt-1;j>0 && val[j-1]<c;j--) {
+						top[j]=top[j-1];
+						val[j]=val[j-1];
+					}
+					top[j]=v;
+					val[j]=c;
+					if (nt==k)
+						kth=val[k-1];
+				}
+			}
+		}
+		free_bfsctx(x);
+	}
+
+	gfree(r);
+	gfree(order);
+	return edges;
+}
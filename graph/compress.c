@@ -0,0 +1,127 @@
+/*
+Info:
+Compressed adjacency list, for graphs whose adj array does not fit in main memory.
+
+Format:
+The sorted list of neighbors v0<v1<...<vk of node u is stored as gaps: v0-u (zigzag encoded, it can be negative), then v1-v0, ..., vk-vk-1.
+Every gap is written as a byte-aligned varint: 7 bits per byte, the high bit is set on all bytes but the last.
+zcd[u] is the position of the list of u in zadj, cd is kept for the degrees.
+On real-world graphs most gaps take one or two bytes, which is 2 to 4 times less than a 32-bit adj.
+
+The lists are read with the iterator of graph.h (nbr_begin/nbr_next or the forneighbors macro), which works on both representations.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <omp.h>
+
+#include "graph.h"
+
+//number of bytes of the varint encoding of x
+static inline unsigned varintsize(uint64_t x){
+	unsigned k=1;
+	while (x>=128) {
+		x>>=7;
+		k++;
+	}
+	return k;
+}
+
+static inline unsigned char* putvarint(unsigned char *z,uint64_t x){
+	while (x>=128) {
+		*(z++)=(x & 127) | 128;
+		x>>=7;
+	}
+	*(z++)=x;
+	return z;
+}
+
+static inline uint64_t zigzag(int64_t x){
+	return ((uint64_t)x<<1) ^ (uint64_t)(x>>63);
+}
+
+//size in bytes of the compressed list of u
+static uint64_t listsize(adjlist *g,unsigned long u){
+	offset_t j;
+	uint64_t size=0;
+
+	if (g->cd[u]==g->cd[u+1])
+		return 0;
+	size=varintsize(zigzag((int64_t)g->adj[g->cd[u]]-(int64_t)u));
+	for (j=g->cd[u]+1;j<g->cd[u+1];j++)
+		size+=varintsize(g->adj[j]-g->adj[j-1]);
+	return size;
+}
+
+//replacing adj by its compressed version, the lists have to be sorted
+void compress_adjlist(adjlist *g){
+	unsigned long u;
+	uint64_t *size;
+
+	if (!(g->flags & GRAPH_SORTED)) {
+		fprintf(stderr,"Only sorted lists of neighbors can be compressed\n");
+		exit(1);
+	}
+	if (g->zadj!=NULL)
+		return;
+
+	size=malloc((g->n+1)*sizeof(uint64_t));
+	#pragma omp parallel for schedule(dynamic,1024)
+	for (u=0;u<g->n;u++)
+		size[u]=listsize(g,u);
+
+	g->zcd=galloc((g->n+1)*sizeof(uint64_t),"zcd");
+	g->zcd[0]=0;
+	for (u=0;u<g->n;u++)
+		g->zcd[u+1]=g->zcd[u]+size[u];
+	free(size);
+
+	g->zadj=galloc(g->zcd[g->n]+1,"zadj");
+
+	#pragma omp parallel for schedule(dynamic,1024)
+	for (u=0;u<g->n;u++) {
+		unsigned char *z=g->zadj+g->zcd[u];
+		offset_t j=g->cd[u];
+		if (j<g->cd[u+1]) {
+			z=putvarint(z,zigzag((int64_t)g->adj[j]-(int64_t)u));
+			for (j++;j<g->cd[u+1];j++)
+				z=putvarint(z,g->adj[j]-g->adj[j-1]);
+		}
+	}
+
+	if (g->map==NULL)
+		gfree(g->adj);
+	g->adj=NULL;
+	g->flags|=GRAPH_COMPRESSED;
+}
+
+//going back to plain lists, for the programs that index adj directly
+void uncompress_adjlist(adjlist *g){
+	unsigned long u;
+
+	if (g->zadj==NULL)
+		return;
+	g->adj=galloc(g->cd[g->n]*sizeof(node_t),"adj");
+
+	#pragma omp parallel for schedule(dynamic,1024)
+	for (u=0;u<g->n;u++) {
+		nbriter it;
+		node_t v;
+		offset_t j=g->cd[u];
+		forneighbors(g,u,v,it)
+			g->adj[j++]=v;
+	}
+
+	if (g->map==NULL) {
+		gfree(g->zcd);
+		gfree(g->zadj);
+	}
+	g->zcd=NULL;
+	g->zadj=NULL;
+	g->flags&=~GRAPH_COMPRESSED;
+}
+
+//size in bytes of the lists of neighbors
+uint64_t adjbytes(adjlist *g){
+	return (g->zadj!=NULL) ? g->zcd[g->n] : g->cd[g->n]*sizeof(node_t);
+}
@@ -0,0 +1,231 @@
+/*
+Info:
+Binary CSR files: the adjacency list is written once (see ../mkcsr.c) and then mapped read-only in memory by the tools.
+Loading is then immediate and concurrent jobs on the same graph share the page cache.
+
+Format (native byte order, little-endian on x86):
+- header: magic "CPA-CSR", version, flags (GRAPH_*), n, e and the length of adj;
+- cd: n+1 offset_t;
+- adj: concatenated lists of neighbors, 2e node_t (e if the graph is directed).
+node_t and offset_t are 64-bit if the flag GRAPH_64 is set, 32-bit otherwise.
+If the flag GRAPH_COMPRESSED is set, adj is replaced by zcd (n+1 uint64_t, 8-byte aligned) and zadj (compressed lists, see compress.c),
+the length of adj in the header is then the size of zadj in bytes.
+If the flag GRAPH_IDS is set, the original IDs of the nodes follow (n uint64_t, 8-byte aligned, see idmap.c).
+A 64-bit file is handed over to the 64-bit build of the program (see width.c), a 32-bit file read by a 64-bit build is widened in memory.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "graph.h"
+
+#define CSR_MAGIC "CPA-CSR"
+#define CSR_VERSION 3
+
+typedef struct {
+	char magic[8];
+	uint32_t version;
+	uint32_t flags;//GRAPH_* flags
+	uint64_t n;//number of nodes
+	uint64_t e;//number of edges
+	uint64_t nadj;//length of adj (size of zadj if compressed)
+} csrheader;
+
+//positions of the arrays in a CSR file
+typedef struct {
+	uint64_t cd,zcd,adj,ids,end;
+} csrlayout;
+
+static csrlayout layout(csrheader *h){
+	csrlayout l;
+	uint64_t w=(h->flags & GRAPH_64) ? 8 : 4;
+
+	l.cd=sizeof(csrheader);
+	l.zcd=(l.cd+(h->n+1)*w+7)/8*8;
+	if (h->flags & GRAPH_COMPRESSED) {
+		l.adj=l.zcd+(h->n+1)*sizeof(uint64_t);
+		l.end=l.adj+h->nadj;
+	}
+	else {
+		l.adj=l.cd+(h->n+1)*w;
+		l.end=l.adj+h->nadj*w;
+	}
+	l.ids=(l.end+7)/8*8;
+	if (h->flags & GRAPH_IDS)
+		l.end=l.ids+h->n*sizeof(uint64_t);
+	return l;
+}
+
+//writing the adjacency list in a CSR file
+void writecsr(adjlist *g,char *output){
+	csrheader h;
+	csrlayout l;
+	uint64_t zero=0,pad;
+	int ok;
+	FILE *file=fopen(output,"wb");
+
+	if (file==NULL) {
+		fprintf(stderr,"Cannot write %s\n",output);
+		exit(1);
+	}
+	memset(&h,0,sizeof(csrheader));
+	strcpy(h.magic,CSR_MAGIC);
+	h.version=CSR_VERSION;
+	h.flags=(g->ids!=NULL) ? g->flags|GRAPH_IDS : g->flags & ~GRAPH_IDS;
+	h.n=g->n;
+	h.e=g->e;
+	h.nadj=(g->zadj!=NULL) ? g->zcd[g->n] : g->cd[g->n];
+	l=layout(&h);
+
+	ok=(fwrite(&h,sizeof(csrheader),1,file)==1);
+	ok=ok && (fwrite(g->cd,sizeof(offset_t),g->n+1,file)==g->n+1);
+	if (g->zadj!=NULL) {
+		pad=l.zcd-l.cd-(g->n+1)*sizeof(offset_t);//zcd is 8-byte aligned
+		ok=ok && (fwrite(&zero,1,pad,file)==pad);
+		ok=ok && (fwrite(g->zcd,sizeof(uint64_t),g->n+1,file)==g->n+1);
+		ok=ok && (fwrite(g->zadj,1,h.nadj,file)==h.nadj);
+	}
+	else
+		ok=ok && (fwrite(g->adj,sizeof(node_t),h.nadj,file)==h.nadj);
+	if (g->ids!=NULL) {
+		pad=l.ids-(l.adj+((g->zadj!=NULL) ? h.nadj : h.nadj*sizeof(node_t)));//ids is 8-byte aligned
+		ok=ok && (fwrite(&zero,1,pad,file)==pad);
+		ok=ok && (fwrite(g->ids,sizeof(uint64_t),g->n,file)==g->n);
+	}
+	if (!ok || fclose(file)!=0) {
+		fprintf(stderr,"Error while writing %s\n",output);
+		exit(1);
+	}
+}
+
+#ifdef GRAPH64
+//copying the 32-bit arrays of a CSR file into 64-bit arrays
+static void widecopy(adjlist *g,csrheader *h){
+	uint32_t *cd=(uint32_t*)g->cd,*adj=(uint32_t*)g->adj;
+	uint64_t i;
+
+	g->cd=galloc((g->n+1)*sizeof(offset_t),"cd");
+	#pragma omp parallel for
+	for (i=0;i<g->n+1;i++)
+		g->cd[i]=cd[i];
+	if (adj!=NULL) {
+		g->adj=galloc(h->nadj*sizeof(node_t),"adj");
+		#pragma omp parallel for
+		for (i=0;i<h->nadj;i++)
+			g->adj[i]=adj[i];
+	}
+	g->flags|=GRAPH_64;
+}
+#endif
+
+//copy of an array of the mapping, placed as asked by GRAPH_ALLOC (see alloc.c): the threads copy the parts they will process
+static void* placecopy(void *a,size_t size,const char *name){
+	char *p=galloc(size,name);
+	size_t i;
+
+	#pragma omp parallel for schedule(static)
+	for (i=0;i<size;i+=4096)
+		memcpy(p+i,(char*)a+i,(size-i<4096) ? size-i : 4096);
+	return p;
+}
+
+static inline int inmap(adjlist *g,void *p){
+	return p!=NULL && (char*)p>=(char*)g->map && (char*)p<(char*)g->map+g->mapsize;
+}
+
+//mapping a CSR file in memory, returns NULL if the file is not a CSR file
+adjlist* mapcsr(char *input){
+	csrheader h;
+	csrlayout l;
+	struct stat st;
+	adjlist *g;
+	char *map;
+	int fd=open(input,O_RDONLY);
+
+	if (fd<0)
+		return NULL;
+	if (fstat(fd,&st)!=0 || !S_ISREG(st.st_mode) || read(fd,&h,sizeof(csrheader))!=sizeof(csrheader) || memcmp(h.magic,CSR_MAGIC,sizeof(h.magic))!=0) {
+		close(fd);
+		return NULL;
+	}
+	if (h.version!=CSR_VERSION) {
+		fprintf(stderr,"%s: unsupported CSR version %u (expected %u), convert the graph again\n",input,h.version,CSR_VERSION);
+		exit(1);
+	}
+#ifndef GRAPH64
+	if (h.flags & GRAPH_64) {
+		close(fd);
+		widen();
+	}
+#endif
+	l=layout(&h);
+	if ((uint64_t)st.st_size<l.end) {
+		fprintf(stderr,"%s: truncated CSR file\n",input);
+		exit(1);
+	}
+
+	map=mmap(NULL,st.st_size,PROT_READ,MAP_SHARED,fd,0);
+	close(fd);
+	if (map==MAP_FAILED) {
+		fprintf(stderr,"Cannot map %s\n",input);
+		exit(1);
+	}
+
+	g=malloc(sizeof(adjlist));
+	g->n=h.n;
+	g->e=h.e;
+	g->flags=h.flags;
+	g->cd=(offset_t*)(map+l.cd);
+	if (h.flags & GRAPH_COMPRESSED) {
+		g->adj=NULL;
+		g->zcd=(uint64_t*)(map+l.zcd);
+		g->zadj=(unsigned char*)(map+l.adj);
+	}
+	else {
+		g->adj=(node_t*)(map+l.adj);
+		g->zcd=NULL;
+		g->zadj=NULL;
+	}
+	g->ids=(h.flags & GRAPH_IDS) ? (uint64_t*)(map+l.ids) : NULL;
+	g->byid=NULL;
+	g->map=map;
+	g->mapsize=st.st_size;
+#ifdef GRAPH64
+	if (!(h.flags & GRAPH_64))
+		widecopy(g,&h);
+#endif
+	if (allocpolicy()) {//the pages of the mapping are on the node that read the file
+		if (inmap(g,g->cd))
+			g->cd=placecopy(g->cd,(g->n+1)*sizeof(offset_t),"cd");
+		if (inmap(g,g->adj))
+			g->adj=placecopy(g->adj,h.nadj*sizeof(node_t),"adj");
+		if (inmap(g,g->zadj)) {
+			g->zadj=placecopy(g->zadj,g->zcd[g->n],"zadj");
+			g->zcd=placecopy(g->zcd,(g->n+1)*sizeof(uint64_t),"zcd");
+		}
+	}
+	sortbyid(g);
+
+	return g;
+}
+
+//loading the adjacency list from a CSR file if possible, otherwise from a text edge list (without building the edge array, see stream.c)
+adjlist* loadadjlist(char *input,int directed){
+	adjlist *g=mapcsr(input);
+
+	if (g!=NULL) {
+		if (((g->flags & GRAPH_DIRECTED)!=0)!=(directed!=0)) {
+			fprintf(stderr,"%s holds %s graph, this program needs %s one\n",input,directed ? "an undirected" : "a directed",directed ? "a directed" : "an undirected");
+			exit(1);
+		}
+		return g;
+	}
+
+	return streamadjlist(input,directed);
+}
@@ -0,0 +1,488 @@
+/*
+Info:
+Exact diameter and radius with bounds on the eccentricities, the graph is assumed to be undirected.
+The diameter is the largest eccentricity over all the connected components, the radius is the smallest eccentricity in the largest component.
+
+How it works:
+Every node v has a lower bound lo[v] and an upper bound hi[v] on its eccentricity. A BFS from v gives its eccentricity e and the
+distance d from v to every node w of its component, and by the triangle inequality max(d,e-d)<=ecc(w)<=e+d
+(Takes and Kosters, "Determining the diameter of small world networks", CIKM 2011). The diameter is then between the largest lo
+and the largest hi, the radius between the smallest lo and the smallest hi, and the search stops as soon as these bounds meet.
+- A first BFS from one node of every component finds the components (nodes of a component are consecutive in nodes[]) and
+  bounds the eccentricities by min(e+d,size-1); components whose bound is not above the diameter found so far are not searched.
+- In the largest component (and in the others that are searched), a 4-sweep (Crescenzi, Grossi, Habib, Lanzi and Marino, 2013)
+  from the node of largest degree gives a good lower bound on the diameter and a central node, which gives a good upper bound.
+- Then rounds of BFS are run until the bounds meet: the nodes of largest hi (they could make the diameter larger) and of smallest lo
+  (they could make the radius smaller) are taken alternately, by decreasing degree on ties. Each round runs one BFS per thread,
+  every thread searching in its own workspace (bfsctx), so a BFS of a small component costs only its size.
+Only a handful of BFS are usually needed on large small-world graphs. With a time budget, the bounds reached when it expires are returned.
+
+eccentricities() runs the same rounds until the bounds of every node meet (Takes and Kosters, "Computing the eccentricity
+distribution of a large graph", Algorithms 2013), with two more rules:
+- a node of degree 1 whose neighbor u has a larger degree (a leaf) has eccentricity ecc(u)+1, every path from it going through u:
+  the leaves are put at the end of their component, never searched nor waited for, and get their eccentricity from u at the end;
+  a BFS from u also gives d(v,u)+1<=ecc(v) to the other nodes v, as a leaf of u is at this distance;
+- with c the central node given by the 4-sweep, a node v is at distance at most d(c,v)+L from every node not searched yet (nor leaf
+  of a node searched), L being the largest distance from c to them, so ecc(v)<=max(lo(v),d(c,v)+L) (Li, Qiao, Qin, Zhang, Chang
+  and Lin, "Exacting eccentricity for small-world networks", ICDE 2018): the periphery of the graph is searched first to lower L.
+The rounds take alternately the nodes of largest hi, of smallest lo and the farthest from c not searched yet.
+On a preferential attachment graph of 100k nodes (half of them leaves), 2.7k BFS give all the eccentricities.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <omp.h>
+
+#include "graph.h"
+
+//what solve() computes
+#define ECC_DIAMETER 0
+#define ECC_RADIUS 1 //diameter and radius
+#define ECC_ALL 2 //eccentricity of every node
+
+//flags of the nodes (ECC_ALL only)
+#define ECC_SOURCE 1 //a BFS was run from the node
+#define ECC_LEAF 2 //the node has a neighbor of degree 1 which is not searched
+
+//nodes picked by pick()
+#define PICK_LOW 0 //smallest lo
+#define PICK_HIGH 1 //largest hi
+#define PICK_FAR 2 //farthest from the central node, not searched yet
+
+typedef struct {
+	adjlist *g;
+	unsigned *lo,*hi;//bounds on the eccentricity of every node
+	node_t *nodes;//nodes grouped by component
+	int nt;//number of workspaces, one per thread
+	bfsctx **x;
+	unsigned long nbfs;//number of BFS run
+	unsigned char *flag;//ECC_* flags of every node, NULL unless all the eccentricities are computed
+	unsigned *dc;//distance from the central node of its component, NULL unless all the eccentricities are computed
+} eccbounds;
+
+static inline offset_t degree(adjlist *g,unsigned long u){
+	return g->cd[u+1]-g->cd[u];
+}
+
+//eccentricity of the source of the last search of x
+static inline unsigned ecc(bfsctx *x){
+	return x->dist[x->queue[x->len-1]];
+}
+
+//bounds given by the last search of x
+static void update(eccbounds *b,bfsctx *x){
+	unsigned e=ecc(x),p=0;
+	unsigned long j;
+
+	if (b->flag!=NULL) {
+		b->flag[x->queue[0]]|=ECC_SOURCE;
+		p=(b->flag[x->queue[0]] & ECC_LEAF)!=0;//a leaf of the source is at distance d+1 of the others
+	}
+	#pragma omp parallel for
+	for (j=0;j<x->len;j++) {
+		node_t w=x->queue[j];
+		unsigned d=x->dist[w],l=(d>e-d)?d:e-d;
+		if (d+p>l)
+			l=d+p;
+		if (l>b->lo[w])
+			b->lo[w]=l;
+		if (e+d<b->hi[w])
+			b->hi[w]=e+d;
+	}
+}
+
+//BFS from u in x and bounds
+static void search(eccbounds *b,bfsctx *x,unsigned long u){
+	bfs_ctx(b->g,x,u);
+	update(b,x);
+	b->nbfs++;
+}
+
+//node at distance d from the source of the last search of x, on a shortest path to w
+static node_t midpoint(adjlist *g,bfsctx *x,node_t w,unsigned d){
+	node_t v;
+	nbriter it;
+
+	while (x->dist[w]>d) {
+		forneighbors(g,w,v,it)
+			if (x->stamp[v]==x->epoch && x->dist[v]+1==x->dist[w])
+				break;
+		w=v;
+	}
+	return w;
+}
+
+static eccbounds* mkeccbounds(adjlist *g){
+	eccbounds *b=malloc(sizeof(eccbounds));
+	int t;
+
+	b->g=g;
+	b->lo=galloc(g->n*sizeof(unsigned),"ecc lower bounds");
+	b->hi=galloc(g->n*sizeof(unsigned),"ecc upper bounds");
+	memset(b->hi,0xff,g->n*sizeof(unsigned));
+	b->nodes=galloc(g->n*sizeof(node_t),"nodes by component");
+	b->nt=omp_get_max_threads();
+	b->x=malloc(b->nt*sizeof(bfsctx*));
+	for (t=0;t<b->nt;t++)
+		b->x[t]=mkbfsctx(g);
+	b->nbfs=0;
+	b->flag=NULL;
+	b->dc=NULL;
+	return b;
+}
+
+static void free_eccbounds(eccbounds *b){
+	int t;
+
+	for (t=0;t<b->nt;t++)
+		free_bfsctx(b->x[t]);
+	free(b->x);
+	gfree(b->lo);
+	gfree(b->hi);
+	gfree(b->nodes);
+	free(b->flag);
+	gfree(b->dc);
+	free(b);
+}
+
+//first BFS from every component, start[c]..start[c+1]-1 are the positions of the nodes of component c in b->nodes
+//returns the number of components
+static unsigned long components(eccbounds *b,unsigned long *start){
+	adjlist *g=b->g;
+	bfsctx *x=b->x[0];
+	unsigned long u,j,l,pos=0,nc=0;
+
+	for (u=0;u<g->n;u++) {
+		if (b->hi[u]!=(unsigned)-1)//already reached
+			continue;
+		search(b,x,u);
+		l=x->len;
+		memcpy(b->nodes+pos,x->queue,l*sizeof(node_t));
+		for (j=0;j<l;j++)//the eccentricity is also at most size-1
+			if (b->hi[x->queue[j]]>l-1)
+				b->hi[x->queue[j]]=l-1;
+		start[nc++]=pos;
+		pos+=l;
+	}
+	start[nc]=pos;
+	return nc;
+}
+
+//largest and smallest lo and hi in the nodes nodes[a..b-1]
+static void range(eccbounds *b,unsigned long a,unsigned long z,unsigned *dl,unsigned *du,unsigned *rl,unsigned *ru){
+	unsigned long j;
+	unsigned maxlo=0,maxhi=0,minlo=-1,minhi=-1;
+
+	#pragma omp parallel for reduction(max:maxlo,maxhi) reduction(min:minlo,minhi)
+	for (j=a;j<z;j++) {
+		node_t w=b->nodes[j];
+		if (b->lo[w]>maxlo)
+			maxlo=b->lo[w];
+		if (b->hi[w]>maxhi)
+			maxhi=b->hi[w];
+		if (b->lo[w]<minlo)
+			minlo=b->lo[w];
+		if (b->hi[w]<minhi)
+			minhi=b->hi[w];
+	}
+	*dl=maxlo;
+	*du=maxhi;
+	*rl=minlo;
+	*ru=minhi;
+}
+
+//distance from the central node to the farthest node covered by w: w, or its leaves if it has some
+static inline unsigned far(eccbounds *b,node_t w){
+	return b->dc[w]+((b->flag[w] & ECC_LEAF)!=0);
+}
+
+//candidate of pick(): position in nodes[], and key and degree by which it is ranked
+typedef struct {
+	unsigned long j;
+	unsigned key;
+	offset_t deg;
+} cand;
+
+//1 if x is ranked before y: larger key, then larger degree, then first in nodes[]
+static inline int before(const cand *x,const cand *y){
+	if (x->key!=y->key)
+		return x->key>y->key;
+	if (x->deg!=y->deg)
+		return x->deg>y->deg;
+	return x->j<y->j;
+}
+
+//inserting c in l, the *len best candidates by decreasing rank (at most k)
+static void insert(cand *l,int *len,int k,const cand *c){
+	int i;
+
+	if (*len==k && !before(c,l+k-1))
+		return;
+	i=(*len<k) ? (*len)++ : k-1;
+	for (;i>0 && before(c,l+i-1);i--)
+		l[i]=l[i-1];
+	l[i]=*c;
+}
+
+//the (at most) k best nodes of nodes[a..z-1] in best, by largest degree on ties: open (lo<hi) of smallest lo (PICK_LOW)
+//or largest hi (PICK_HIGH), or not searched yet and farthest from the central node (PICK_FAR), returns their number
+//one parallel pass: every thread keeps the k best of its part, then the lists of the threads are merged
+static int pick(eccbounds *b,unsigned long a,unsigned long z,int how,node_t *best,int k){
+	adjlist *g=b->g;
+	cand *l=malloc((b->nt+1)*k*sizeof(cand)),*m=l+b->nt*k;
+	int *len=calloc(b->nt,sizeof(int)),n=0,t,i;
+
+	#pragma omp parallel num_threads(b->nt) if (z-a>=4096)
+	{
+		cand *lt=l+omp_get_thread_num()*k,c;
+		unsigned long j;
+		int nl=0;
+
+		#pragma omp for schedule(static)
+		for (j=a;j<z;j++) {
+			node_t w=b->nodes[j];
+			if (how==PICK_FAR ? (b->flag[w] & ECC_SOURCE)!=0 : b->lo[w]==b->hi[w])
+				continue;
+			c.j=j;
+			c.key=(how==PICK_HIGH) ? b->hi[w] : (how==PICK_LOW) ? (unsigned)-1-b->lo[w] : far(b,w);
+			c.deg=degree(g,w);
+			insert(lt,&nl,k,&c);
+		}
+		len[omp_get_thread_num()]=nl;
+	}
+	for (t=0;t<b->nt;t++)
+		for (i=0;i<len[t];i++)
+			insert(m,&n,k,l+t*k+i);
+	for (i=0;i<n;i++)
+		best[i]=b->nodes[m[i].j];
+	free(l);
+	free(len);
+	return n;
+}
+
+//upper bounds from the central node c (Li, Qiao, Qin, Zhang, Chang and Lin, "Exacting eccentricity for small-world networks", ICDE 2018):
+//with L the largest far(w) over the nodes w not searched yet, a node v is at distance at most lo(v) from the nodes searched
+//(and from their leaves) and at most d(c,v)+L from the others, so ecc(v)<=max(lo(v),d(c,v)+L)
+static void tighten(eccbounds *b,unsigned long a,unsigned long z){
+	unsigned long j;
+	unsigned l=0;
+
+	#pragma omp parallel for reduction(max:l)
+	for (j=a;j<z;j++) {
+		node_t w=b->nodes[j];
+		if (!(b->flag[w] & ECC_SOURCE) && far(b,w)>l)
+			l=far(b,w);
+	}
+	#pragma omp parallel for
+	for (j=a;j<z;j++) {
+		node_t w=b->nodes[j];
+		unsigned h=(b->lo[w]>b->dc[w]+l) ? b->lo[w] : b->dc[w]+l;
+		if (h<b->hi[w])
+			b->hi[w]=h;
+	}
+}
+
+//number of nodes of nodes[a..z-1] whose bounds have not met
+static unsigned long unsettled(eccbounds *b,unsigned long a,unsigned long z){
+	unsigned long j,k=0;
+
+	#pragma omp parallel for reduction(+:k)
+	for (j=a;j<z;j++)
+		if (b->lo[b->nodes[j]]<b->hi[b->nodes[j]])
+			k++;
+	return k;
+}
+
+//bounds on the diameter of the component nodes[a..z-1] (ECC_DIAMETER), also on its radius (ECC_RADIUS),
+//or on the eccentricity of each of its nodes (ECC_ALL), until they meet or until the deadline
+static void solve(eccbounds *b,unsigned long a,unsigned long z,int what,double deadline){
+	adjlist *g=b->g;
+	bfsctx *x=b->x[0];
+	node_t *sel=malloc(4*b->nt*sizeof(node_t)),*best[3],u=b->nodes[a];
+	unsigned long j;
+	unsigned dl,du,rl,ru,e;
+	int k,t,i,s,nb[3],used[3],side=0,sides=(what==ECC_ALL) ? 3 : 2,central=0;
+	static const int how[3]={PICK_HIGH,PICK_LOW,PICK_FAR};
+
+	for (s=0;s<3;s++)
+		best[s]=sel+(s+1)*b->nt;
+
+	if (what==ECC_ALL && unsettled(b,a,z)==0) {//the first BFS was enough (small components)
+		free(sel);
+		return;
+	}
+	//4-sweep from the node of largest degree
+	for (j=a;j<z;j++)
+		if (degree(g,b->nodes[j])>degree(g,u))
+			u=b->nodes[j];
+	for (i=0;i<2 && omp_get_wtime()<deadline;i++) {
+		search(b,x,u);
+		search(b,x,x->queue[x->len-1]);
+		e=ecc(x);
+		u=midpoint(g,x,x->queue[x->len-1],e/2);
+	}
+	if (omp_get_wtime()<deadline) {
+		search(b,x,u);
+		if (what==ECC_ALL) {
+			for (j=0;j<x->len;j++)
+				b->dc[x->queue[j]]=x->dist[x->queue[j]];
+			central=1;
+		}
+	}
+
+	for (;;) {
+		if (central)
+			tighten(b,a,z);
+		range(b,a,z,&dl,&du,&rl,&ru);
+		if (omp_get_wtime()>=deadline)
+			break;
+		if (what==ECC_ALL ? unsettled(b,a,z)==0 : dl==du && (what==ECC_DIAMETER || rl==ru))
+			break;
+		//one node per thread, alternately for the diameter (largest hi), for the radius (smallest lo) and, for all the
+		//eccentricities, for tighten() (farthest from the central node), starting with the next side in the next round:
+		//the nt best nodes of each side are enough, a node taken by one side being skipped by the others
+		for (s=0;s<sides;s++) {
+			used[s]=0;
+			if ((s==0 && (what==ECC_ALL || dl<du)) || (s==1 && (what==ECC_ALL || (what==ECC_RADIUS && rl<ru))) || (s==2 && central))
+				nb[s]=pick(b,a,z,how[s],best[s],b->nt);
+			else
+				nb[s]=0;
+		}
+		k=0;
+		for (i=side;k<b->nt && i<side+sides*b->nt;i++) {
+			s=i%sides;
+			for (;used[s]<nb[s];used[s]++) {
+				for (t=0;t<k && sel[t]!=best[s][used[s]];t++);
+				if (t==k)
+					break;
+			}
+			if (used[s]<nb[s])
+				sel[k++]=best[s][used[s]++];
+		}
+		if (k==0)
+			break;
+		#pragma omp parallel for num_threads(k) schedule(static,1)
+		for (t=0;t<k;t++)
+			bfs_ctx(g,b->x[t],sel[t]);
+		for (t=0;t<k;t++)
+			update(b,b->x[t]);
+		b->nbfs+=k;
+		side=(side+1)%sides;
+	}
+	free(sel);
+}
+
+//diameter in [*dlb,*dub] and radius of the largest component in [*rlb,*rub], equal bounds unless the budget (in seconds, 0 for none) expired
+//returns the number of BFS run
+unsigned long diameter_radius(adjlist *g,double budget,unsigned *dlb,unsigned *dub,unsigned *rlb,unsigned *rub){
+	eccbounds *b;
+	unsigned long *start,nc,c,big=0,nbfs,j;
+	unsigned dl=0,du,rl,ru,l,h;
+	double deadline=(budget>0) ? omp_get_wtime()+budget : 1e300;
+
+	*dlb=*dub=*rlb=*rub=0;
+	if (g->n==0)
+		return 0;
+	b=mkeccbounds(g);
+	start=malloc((g->n+1)*sizeof(unsigned long));
+	nc=components(b,start);
+	for (c=1;c<nc;c++)
+		if (start[c+1]-start[c]>start[big+1]-start[big])
+			big=c;
+
+	solve(b,start[big],start[big+1],ECC_RADIUS,deadline);
+	range(b,start[big],start[big+1],&dl,&du,rlb,rub);
+	for (c=0;c<nc;c++) {
+		if (c==big || omp_get_wtime()>=deadline)
+			continue;
+		range(b,start[c],start[c+1],&l,&h,&rl,&ru);
+		if (h>dl)//could be larger than the diameter found so far
+			solve(b,start[c],start[c+1],ECC_DIAMETER,deadline);
+		range(b,start[c],start[c+1],&l,&h,&rl,&ru);
+		if (l>dl)
+			dl=l;
+	}
+
+	//the components that were not searched keep their first bounds
+	*dlb=*dub=0;
+	for (j=0;j<g->n;j++) {
+		if (b->lo[j]>*dlb)
+			*dlb=b->lo[j];
+		if (b->hi[j]>*dub)
+			*dub=b->hi[j];
+	}
+	if (*dub<*dlb)
+		*dub=*dlb;
+	nbfs=b->nbfs;
+	free(start);
+	free_eccbounds(b);
+	return nbfs;
+}
+
+//1 if u has degree 1 and its neighbor has a larger degree
+static int leaf(adjlist *g,unsigned long u){
+	nbriter it;
+	node_t v;
+
+	if (degree(g,u)!=1)
+		return 0;
+	nbr_begin(g,u,&it);
+	nbr_next(&it,&v);
+	return degree(g,v)>1;
+}
+
+//eccentricity of every node in lo and hi (lo[u]==hi[u]), or the bounds reached when the budget (in seconds, 0 for none) expired
+//returns the number of BFS run
+unsigned long eccentricities(adjlist *g,double budget,unsigned *lo,unsigned *hi){
+	eccbounds *b;
+	unsigned long *start,nc,c,j,m,nbfs;
+	double deadline=(budget>0) ? omp_get_wtime()+budget : 1e300;
+
+	if (g->n==0)
+		return 0;
+	b=mkeccbounds(g);
+	b->flag=calloc(g->n,1);
+	b->dc=galloc(g->n*sizeof(unsigned),"distances to the center");
+	for (j=0;j<g->n;j++) {//before any BFS, so that the BFS from their neighbors bound the others with the leaves
+		if (leaf(g,j)) {
+			node_t u;
+			nbriter it;
+			nbr_begin(g,j,&it);
+			nbr_next(&it,&u);
+			b->flag[u]|=ECC_LEAF;
+		}
+	}
+	start=malloc((g->n+1)*sizeof(unsigned long));
+	nc=components(b,start);
+
+	for (c=0;c<nc;c++) {
+		//the leaves at the end of the component: nodes[start[c]..m-1] are searched
+		m=start[c+1];
+		for (j=start[c];j<m;) {
+			if (leaf(g,b->nodes[j])) {
+				node_t w=b->nodes[j];
+				b->nodes[j]=b->nodes[--m];
+				b->nodes[m]=w;
+			}
+			else
+				j++;
+		}
+		solve(b,start[c],m,ECC_ALL,deadline);
+		for (j=m;j<start[c+1];j++) {
+			node_t w=b->nodes[j],u;
+			nbriter it;
+			nbr_begin(g,w,&it);
+			nbr_next(&it,&u);
+			b->lo[w]=b->lo[u]+1;
+			b->hi[w]=b->hi[u]+1;
+		}
+	}
+
+	memcpy(lo,b->lo,g->n*sizeof(unsigned));
+	memcpy(hi,b->hi,g->n*sizeof(unsigned));
+	nbfs=b->nbfs;
+	free(start);
+	free_eccbounds(b);
+	return nbfs;
+}
@@ -0,0 +1,335 @@
+/*
+Info:
+Graph core shared by all the C tools of the repository (root directory, BFS-triangle, kcore and PageRank).
+It loads an edge list from a text file and builds the adjacency list, so that every tool uses the same code.
+The nodes are renumbered 0..n-1 when the IDs of the file are sparse (see idmap.c), the original IDs are kept in ids.
+The adjacency list can also be saved once in a binary CSR file (see csrfile.c) that all the tools map in memory instead of parsing the text file again.
+
+Node IDs (node_t) and edge offsets (offset_t) are 32-bit by default, which halves the memory traffic of the adjacency list.
+Compiling with -DGRAPH64 makes them 64-bit. Every tool is built twice, e.g. "bfs" and "bfs64":
+when the graph has more than 2^32 nodes or 2^32 entries in adj, the 32-bit build re-executes the 64-bit one with the same arguments (see width.c).
+
+To compile:
+"make" in this directory builds libgraph.a (32-bit) and libgraph64.a (64-bit).
+A tool is then compiled with "gcc tool.c -O9 -o tool -I../graph ../graph/libgraph.a -fopenmp -lz -lbz2"
+and "gcc tool.c -O9 -o tool64 -DGRAPH64 -I../graph ../graph/libgraph64.a -fopenmp -lz -lbz2".
+*/
+
+#ifndef GRAPH_H
+#define GRAPH_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef GRAPH64
+typedef uint64_t node_t;
+typedef uint64_t offset_t;
+#define NODE_MAX UINT64_MAX
+#define OFFSET_MAX UINT64_MAX
+#else
+typedef uint32_t node_t;
+typedef uint32_t offset_t;
+#define NODE_MAX UINT32_MAX
+#define OFFSET_MAX UINT32_MAX
+#endif
+
+//flags of an adjacency list, also stored in the header of CSR files
+#define GRAPH_DIRECTED 1 //edge (s,t) is only in the list of s
+#define GRAPH_SORTED 2 //every list of neighbors is sorted by increasing ID
+#define GRAPH_64 4 //node_t and offset_t are 64-bit
+#define GRAPH_COMPRESSED 8 //the lists of neighbors are in zadj instead of adj (see compress.c)
+#define GRAPH_IDS 16 //the nodes were renumbered, ids holds their original IDs
+#define GRAPH_REORDERED 32 //ids is not increasing (see reorder.c)
+
+//orders of reorder.c
+#define ORDER_DEGREE 1
+#define ORDER_RCM 2
+#define ORDER_GORDER 3
+
+#define NONODE ((unsigned long)-1) //returned by findnode for an ID that is not in the graph
+
+typedef struct {
+	node_t s;
+	node_t t;
+} edge;
+
+//edge list structure:
+typedef struct {
+	unsigned long n;//number of nodes
+	unsigned long e;//number of edges
+	edge *edges;//list of edges
+	uint64_t *ids;//original ID of each node, NULL if the IDs are 0..n-1
+} edgelist;
+
+//adjacency list structure:
+typedef struct {
+	unsigned long n;//number of nodes
+	unsigned long e;//number of edges
+	offset_t *cd;//cumulative degree cd[0]=0 length=n+1
+	node_t *adj;//concatenated lists of neighbors of all nodes, NULL if the graph is compressed
+	unsigned char *zadj;//compressed lists of neighbors, NULL if the graph is not compressed
+	uint64_t *zcd;//zcd[u] is the position of the list of u in zadj, length=n+1
+	uint64_t *ids;//original ID of each node, NULL if the IDs are 0..n-1
+	node_t *byid;//nodes sorted by original ID if ids is not increasing (GRAPH_REORDERED), NULL otherwise (see idmap.c)
+	unsigned flags;//GRAPH_* flags
+	void *map;//memory mapping of the CSR file cd and adj point to, NULL if they were malloc'ed
+	size_t mapsize;//length of the mapping
+} adjlist;
+
+//adjacency matrix stored as bitset rows (see bitmatrix.c):
+typedef struct {
+	unsigned long n;//number of nodes
+	unsigned long e;//number of edges
+	unsigned long w;//number of 64-bit words of a row (multiple of 4)
+	uint64_t *rows;//row u is rows[u*w..u*w+w-1], bit v of row u is set if (u,v) is an edge
+} bitmatrix;
+
+//temporary arrays of the kernels of analysis.c, allocated by the first kernel that needs them and shared by the next ones:
+typedef struct {
+	unsigned long n;//number of nodes of the graph
+	unsigned *dist;//distances of a BFS, length n
+	node_t *queue;//queue of a BFS or list of nodes by degree, length n
+	unsigned long *cnt;//positions or counters, length n+1
+	double *x,*y;//vectors of PageRank, length n
+} scratch;
+
+//degree statistics (see analysis.c):
+typedef struct {
+	unsigned long mindeg,maxdeg;
+	unsigned long isolated;//number of nodes of degree 0
+	double avgdeg;
+} degstats;
+
+//level of a BFS (see bfs.c):
+typedef struct {
+	unsigned long nodes;//number of nodes at this distance
+	unsigned long edges;//number of edges scanned to find them
+	int bottomup;//1 if the level was built bottom-up
+} bfslevel;
+
+//BFS workspace of one thread (see bfs.c): a node was reached by the last search iff stamp[v]==epoch,
+//so a search only writes the nodes it reaches and nothing is reset between two searches
+typedef struct {
+	unsigned long n;//number of nodes of the graph
+	unsigned *dist;//distances of the last search, valid for the stamped nodes only, length n
+	unsigned *stamp;//number of the last search that reached each node, length n
+	unsigned epoch;//number of the last search
+	node_t *queue;//nodes reached by the last search by increasing distance, length n
+	unsigned long len;//number of nodes reached by the last search
+} bfsctx;
+
+//distance of v in the last search of c (-1 if not reachable)
+static inline unsigned bfsctx_dist(const bfsctx *c,unsigned long v){
+	return (c->stamp[v]==c->epoch) ? c->dist[v] : (unsigned)-1;
+}
+
+//landmark distance index mapped from a file (see landmark.c):
+typedef struct {
+	unsigned long n;//number of nodes (rows)
+	unsigned long k;//number of landmarks
+	unsigned flags;//LM_IDS, LM_LABELS
+	const uint64_t *lm;//original IDs of the landmarks
+	const uint64_t *ids;//original IDs of the rows (increasing), NULL if row r is the node of ID r
+	const unsigned char *dist;//dist[r*k+i] is the distance from landmark i to the node of row r (or LM_FAR, LM_NONE)
+	const uint64_t *loff;//the label of row r is hub[loff[r]..loff[r+1]-1] and ldist[loff[r]..loff[r+1]-1], NULL without labels
+	const uint32_t *hub;//roots of the label entries
+	const unsigned char *ldist;//distances of the label entries
+	void *map;//memory mapping of the index file
+	size_t mapsize;//length of the mapping
+} lmindex;
+
+static inline uint64_t* bm_row(const bitmatrix *m,unsigned long u){
+	return m->rows+u*m->w;
+}
+
+static inline int bm_get(const bitmatrix *m,unsigned long u,unsigned long v){
+	return (m->rows[u*m->w+v/64]>>(v%64)) & 1;
+}
+
+//iterator over the neighbors of a node, for both plain and compressed lists:
+//	nbriter it;
+//	forneighbors(g,u,v,it) {...}
+typedef struct {
+	const node_t *p;//next neighbor (plain lists)
+	const unsigned char *z;//next byte (compressed lists)
+	offset_t left;//number of neighbors left
+	node_t v;//last neighbor (compressed lists)
+	int first;//1 before the first neighbor (compressed lists)
+} nbriter;
+
+static inline void nbr_begin(const adjlist *g,unsigned long u,nbriter *it){
+	it->left=g->cd[u+1]-g->cd[u];
+	if (g->zadj==NULL) {
+		it->p=g->adj+g->cd[u];
+		it->z=NULL;
+	}
+	else {
+		it->p=NULL;
+		it->z=g->zadj+g->zcd[u];
+		it->v=u;
+		it->first=1;
+	}
+}
+
+static inline int nbr_next(nbriter *it,node_t *v){
+	uint64_t x;
+	unsigned shift;
+
+	if (it->left==0)
+		return 0;
+	it->left--;
+	if (it->p!=NULL) {
+		*v=*(it->p++);
+		return 1;
+	}
+	x=*it->z & 127;
+	for (shift=7;*(it->z++) & 128;shift+=7)
+		x|=(uint64_t)(*it->z & 127)<<shift;
+	if (it->first) {//first gap is relative to the node itself and zigzag encoded
+		it->v+=(x>>1) ^ -(x & 1);
+		it->first=0;
+	}
+	else
+		it->v+=x;
+	*v=it->v;
+	return 1;
+}
+
+#define forneighbors(g,u,v,it) for (nbr_begin((g),(u),&(it));nbr_next(&(it),&(v));)
+
+//original ID of node u, to be used when writing results
+static inline uint64_t nodeid(const adjlist *g,unsigned long u){
+	return (g->ids==NULL) ? u : g->ids[u];
+}
+
+//readedgelist.c
+edgelist* readedgelist(char* input);
+void free_edgelist(edgelist *el);
+
+//adjlist.c
+adjlist* mkadjlist(edgelist* el);
+adjlist* mkadjlist_directed(edgelist* el);
+int isedge(adjlist *g,unsigned long u,unsigned long v);
+void free_adjlist(adjlist *g);
+
+//idmap.c
+void compact_edgelist(edgelist *el);
+void sortbyid(adjlist *g);
+unsigned long findnode(adjlist *g,uint64_t x);
+
+//reorder.c
+node_t* mkorder(adjlist *g,int order);
+adjlist* permute_adjlist(adjlist *g,node_t *rank);
+
+//stream.c
+adjlist* streamadjlist(char *input,int directed);
+
+//canon.c
+void canonicalize(char *input,char *output,int csr,size_t mem,char *tmpdir);
+
+//compress.c
+void compress_adjlist(adjlist *g);
+void uncompress_adjlist(adjlist *g);
+uint64_t adjbytes(adjlist *g);
+
+//csrfile.c
+void writecsr(adjlist *g,char *output);
+adjlist* mapcsr(char *input);
+adjlist* loadadjlist(char *input,int directed);
+
+//bitmatrix.c
+void row_and(uint64_t *dst,const uint64_t *a,const uint64_t *b,unsigned long w);
+void row_or(uint64_t *dst,const uint64_t *a,const uint64_t *b,unsigned long w);
+void row_andnot(uint64_t *dst,const uint64_t *a,const uint64_t *b,unsigned long w);
+unsigned long row_count(const uint64_t *a,unsigned long w);
+unsigned long row_andcount(const uint64_t *a,const uint64_t *b,unsigned long w);
+int row_intersects(const uint64_t *a,const uint64_t *b,unsigned long w);
+bitmatrix* mkbitmatrix(edgelist *el);
+void free_bitmatrix(bitmatrix *m);
+unsigned long bm_common(bitmatrix *m,unsigned long u,unsigned long v);
+unsigned long bm_triangles(bitmatrix *m);
+unsigned *bm_bfs(bitmatrix *m,unsigned long u);
+
+//analysis.c
+scratch* mkscratch(adjlist *g);
+void free_scratch(scratch *s);
+void graphstats(adjlist *g,degstats *st);
+unsigned long triangles(adjlist *g,unsigned long *t);
+unsigned long kcore(adjlist *g,scratch *s,unsigned *core);
+unsigned pagerank(adjlist *g,scratch *s,double alpha,double eps,unsigned maxiter,double *p);
+unsigned diameter_lb(adjlist *g,scratch *s,unsigned nsweeps);
+
+//alloc.c
+void* galloc(size_t size,const char *name);
+void gfree(void *p);
+int allocpolicy(void);
+
+//msbfs.c
+#define MS_SOURCES 256 //largest number of sources of a multi-source BFS
+//multi-source BFS workspace (see msbfs.c): masks of w 64-bit words per node, which are all zero between two searches
+typedef struct {
+	unsigned long n;//number of nodes of the graph
+	int w;//words of the mask of a node, ceil(ns/64) for searches of at most ns sources
+	uint64_t *seen,*visit,*next;//masks of the sources, length n*w
+	node_t *front,*cand;//frontier and nodes touched by a level, length n
+	node_t *done;//nodes reached by the search, whose seen mask is cleared at its end, length n
+	unsigned char *mark;//length n
+} msctx;
+msctx* mkmsctx(adjlist *g,int ns);
+void free_msctx(msctx *c);
+void msbfs(adjlist *g,msctx *c,const node_t *src,int ns,unsigned long *sumdist,unsigned *reach);
+
+//closeness.c
+void closeness(adjlist *g,int harmonic,double *c);
+unsigned long closeness_topk(adjlist *g,int harmonic,unsigned k,node_t *top,double *val);
+
+//betweenness.c
+void betweenness(adjlist *g,double *bc);
+unsigned long rk_samples(adjlist *g,double eps,double delta);
+unsigned long betweenness_rk(adjlist *g,double eps,double delta,unsigned seed,double *bc);
+
+//eccentricity.c
+unsigned long diameter_radius(adjlist *g,double budget,unsigned *dlb,unsigned *dub,unsigned *rlb,unsigned *rub);
+unsigned long eccentricities(adjlist *g,double budget,unsigned *lo,unsigned *hi);
+
+//cc.c
+unsigned long connected_components(adjlist *g,node_t *comp);
+
+//bidir.c
+unsigned bidir_bfs(adjlist *g,bfsctx *fw,bfsctx *bw,unsigned long s,unsigned long t,node_t *path);
+
+//landmark.c
+#define LM_DEGREE 1 //landmarks of largest degree
+#define LM_RANDOM 2 //landmarks drawn uniformly
+#define LM_IDS 1 //the index holds the original IDs of the rows
+#define LM_LABELS 2 //the index holds the labels for exact distances
+#define LM_FAR 254 //distance of 254 or more
+#define LM_NONE 255 //not reachable
+unsigned long mklandmarks(adjlist *g,unsigned k,int select,unsigned seed,int labels,char *output);
+lmindex* maplandmarks(char *input);
+void free_lmindex(lmindex *x);
+unsigned long lm_row(lmindex *x,uint64_t id);
+void lm_bounds(lmindex *x,unsigned long s,unsigned long t,unsigned *lo,unsigned *hi);
+unsigned lm_exact(lmindex *x,unsigned long s,unsigned long t);
+
+//output.c
+#define VAL_U32 1
+#define VAL_U64 2
+#define VAL_F64 3
+#define QUERY_BATCH 65536 //queries read (and answered) at once
+void writevalues(adjlist *g,const void *val,int type,char *output);
+unsigned long readqueries(FILE *file,uint64_t *qs,uint64_t *qt,unsigned long *line);
+
+//width.c
+void widen(void);
+
+//bfs.c
+unsigned *bfs(adjlist *g,unsigned long u);
+unsigned bfs_levels(const bfslevel **l);
+bfsctx* mkbfsctx(adjlist *g);
+void free_bfsctx(bfsctx *c);
+unsigned bfsctx_next(bfsctx *c);
+unsigned long bfs_ctx(adjlist *g,bfsctx *c,unsigned long u);
+
+#endif
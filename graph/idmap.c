@@ -0,0 +1,417 @@
+/*
+Info:
+Compacting the IDs of a text edge list: the nodes are renumbered 0..n-1 in the order of their original IDs,
+so that n is the number of nodes that appear in the file and not the largest ID plus one.
+Graphs whose IDs are hashes or sparse ranges then get arrays (cd, dist, labels...) sized to their actual number of nodes.
+
+How it works:
+Two strategies, chosen from the largest ID and the number of edges found by a first scan of the text:
+- moderate largest ID (at most 64 times the number of edges): the IDs that appear are marked in a bitmap, in parallel,
+  and the new ID of x is the number of marked IDs smaller than x (a rank array per 64-bit word plus a popcount);
+- larger IDs: every chunk collects its endpoints in its own array, sorted and deduplicated in place each time it is full, then the sorted runs
+  are merged pairwise in parallel, and the new ID of x is found by binary search in the sorted distinct IDs.
+Peak memory: the bitmap and its ranks take max/4 bytes, at most 16 bytes per edge. The arrays of the chunks take at most 16 bytes per distinct ID
+of each chunk (16 bytes per edge only if almost no endpoint repeats within a chunk), and the last merge 16 bytes per distinct ID of the graph
+(its two inputs and its output), instead of two arrays of all the endpoints.
+If every ID from 0 to the largest one appears, nothing is renumbered and no translation is done at all.
+Both strategies read the edges through an iterator, so the same code renumbers an edge list already in memory (compact_edgelist).
+
+The adjacency list keeps the original IDs in g->ids (NULL if they are 0..n-1), the tools translate back only when writing results.
+A reordered graph (see reorder.c) also keeps g->byid, its nodes sorted by original ID, so that findnode is a binary search in both cases.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <omp.h>
+
+#include "graph.h"
+#include "internal.h"
+
+#define RUN_MIN 4096 //initial size of the array of IDs of a chunk (sparse IDs)
+
+//edges from which a mapping is built: the k chunks of a text, or an edge list cut in k parts
+typedef struct {
+	textfile *f;//NULL for an edge list
+	edgelist *el;
+	int k;
+} edgesrc;
+
+//edges of one chunk of a source
+typedef struct {
+	const edgesrc *src;
+	size_t p,end;
+} edgeiter;
+
+static void iter_init(edgeiter *it,const edgesrc *src,int i){
+	it->src=src;
+	if (src->f!=NULL) {
+		it->p=chunkstart(src->f,i,src->k);
+		it->end=chunkstart(src->f,i+1,src->k);
+	}
+	else {
+		it->p=src->el->e*i/src->k;
+		it->end=src->el->e*(i+1)/src->k;
+	}
+}
+
+//next edge (s,t) of the chunk, returns 0 at its end
+static inline int iter_next(edgeiter *it,unsigned long *s,unsigned long *t){
+	int ok;
+
+	if (it->src->f==NULL) {
+		if (it->p==it->end)
+			return 0;
+		*s=it->src->el->edges[it->p].s;
+		*t=it->src->el->edges[it->p].t;
+		it->p++;
+		return 1;
+	}
+	while (it->p<it->end) {
+		it->p=parseline(it->src->f->buf,it->end,it->p,s,t,&ok);
+		if (ok)
+			return 1;
+	}
+	return 0;
+}
+
+static int cmpid(const void *a,const void *b){
+	uint64_t x=*(const uint64_t*)a,y=*(const uint64_t*)b;
+	return (x>y)-(x<y);
+}
+
+//removing the duplicates of a sorted array, returns the new length
+static unsigned long dedup(uint64_t *a,unsigned long n){
+	unsigned long i,j=0;
+
+	for (i=0;i<n;i++)
+		if (j==0 || a[i]!=a[j-1])
+			a[j++]=a[i];
+	return j;
+}
+
+//merging two sorted arrays without duplicates into c, returns the length of c
+static unsigned long merge(uint64_t *a,unsigned long na,uint64_t *b,unsigned long nb,uint64_t *c){
+	unsigned long i=0,j=0,k=0;
+
+	while (i<na && j<nb) {
+		if (a[i]<b[j])
+			c[k++]=a[i++];
+		else if (a[i]>b[j])
+			c[k++]=b[j++];
+		else {
+			c[k++]=a[i++];
+			j++;
+		}
+	}
+	while (i<na)
+		c[k++]=a[i++];
+	while (j<nb)
+		c[k++]=b[j++];
+	return k;
+}
+
+//first scan of the text: largest ID, and number of edges in each of the k chunks (ne[i] for chunk i)
+unsigned long scantext(textfile *f,int k,unsigned long *ne){
+	unsigned long max=0;
+	int i;
+
+	if (f->cut!=NULL) {//already scanned while decompressing
+		memcpy(ne,f->ne,k*sizeof(unsigned long));
+		return f->max;
+	}
+	#pragma omp parallel for schedule(dynamic,1) reduction(max:max)
+	for (i=0;i<k;i++) {
+		size_t p=chunkstart(f,i,k),end=chunkstart(f,i+1,k);
+		unsigned long s,t,e=0;
+		int ok;
+
+		while (p<end) {
+			p=parseline(f->buf,end,p,&s,&t,&ok);
+			if (!ok)
+				continue;
+			if (s>max)
+				max=s;
+			if (t>max)
+				max=t;
+			e++;
+		}
+		ne[i]=e;
+	}
+	return max;
+}
+
+//rank of each word of the bitmap and number of distinct IDs
+static void rankbits(idmap *m){
+	unsigned long nw=m->max/64+1,w;
+
+	m->n=0;
+	for (w=0;w<nw;w++) {
+		m->rank[w]=m->n;
+		m->n+=__builtin_popcountll(m->bits[w]);
+	}
+}
+
+//bitmap of the IDs that appear in the source, and rank of each word
+static void mkbitmap(idmap *m,const edgesrc *src){
+	unsigned long nw=m->max/64+1;
+	int i;
+
+	m->bits=calloc(nw,sizeof(uint64_t));
+	m->rank=malloc(nw*sizeof(uint64_t));
+
+	#pragma omp parallel for schedule(dynamic,1)
+	for (i=0;i<src->k;i++) {
+		edgeiter it;
+		unsigned long s,t;
+
+		iter_init(&it,src,i);
+		while (iter_next(&it,&s,&t)) {
+			#pragma omp atomic
+			m->bits[s>>6]|=(uint64_t)1<<(s&63);
+			#pragma omp atomic
+			m->bits[t>>6]|=(uint64_t)1<<(t&63);
+		}
+	}
+
+	rankbits(m);
+}
+
+//IDs collected by one chunk: the array is sorted and deduplicated each time it is full, and only grows if it is then still
+//at least half full, so that it holds at most about twice the distinct IDs of the chunk and not all of its endpoints
+typedef struct {
+	uint64_t *a;
+	unsigned long len,size;
+} idrun;
+
+static void run_push(idrun *r,uint64_t x){
+	if (r->len==r->size) {
+		qsort(r->a,r->len,sizeof(uint64_t),cmpid);
+		r->len=dedup(r->a,r->len);
+		if (2*r->len>=r->size) {
+			r->size=(r->size==0) ? RUN_MIN : 2*r->size;
+			r->a=realloc(r->a,r->size*sizeof(uint64_t));
+		}
+	}
+	r->a[r->len++]=x;
+}
+
+//sorting and deduplicating the k runs in parallel, then merging them two by two, each merge freeing its two inputs
+//returns the sorted distinct values and their number in *n
+static uint64_t* sortruns(idrun *r,int k,unsigned long *n){
+	uint64_t *a;
+	int i,step;
+
+	#pragma omp parallel for schedule(dynamic,1)
+	for (i=0;i<k;i++) {
+		qsort(r[i].a,r[i].len,sizeof(uint64_t),cmpid);
+		r[i].len=dedup(r[i].a,r[i].len);
+		r[i].a=realloc(r[i].a,r[i].len*sizeof(uint64_t)+1);
+	}
+
+	for (step=1;step<k;step*=2) {
+		#pragma omp parallel for schedule(dynamic,1)
+		for (i=0;i<k-step;i+=2*step) {
+			uint64_t *c=malloc((r[i].len+r[i+step].len)*sizeof(uint64_t)+1);
+			unsigned long len=merge(r[i].a,r[i].len,r[i+step].a,r[i+step].len,c);
+			free(r[i].a);
+			free(r[i+step].a);
+			r[i].a=realloc(c,len*sizeof(uint64_t)+1);
+			r[i].len=len;
+		}
+	}
+
+	*n=(k>0) ? r[0].len : 0;
+	a=(k>0) ? r[0].a : malloc(1);
+	free(r);
+	return a;
+}
+
+//sorted distinct IDs that appear in the source
+static void mksorted(idmap *m,const edgesrc *src){
+	idrun *r=calloc(src->k,sizeof(idrun));
+	int i;
+
+	//each chunk collects its endpoints in its own run
+	#pragma omp parallel for schedule(dynamic,1)
+	for (i=0;i<src->k;i++) {
+		edgeiter it;
+		unsigned long s,t;
+
+		iter_init(&it,src,i);
+		while (iter_next(&it,&s,&t)) {
+			run_push(r+i,s);
+			run_push(r+i,t);
+		}
+	}
+
+	m->ids=sortruns(r,src->k,&m->n);
+}
+
+//mapping of the IDs of the source, max being its largest ID and e its number of edges
+static idmap* buildidmap(const edgesrc *src,unsigned long max,unsigned long e){
+	idmap *m=malloc(sizeof(idmap));
+
+	m->max=max;
+	m->bits=NULL;
+	m->rank=NULL;
+	m->ids=NULL;
+
+	if (max/64<=e) {
+		mkbitmap(m,src);
+		if (m->n==max+1) {//every ID appears, nothing to renumber
+			free(m->bits);
+			free(m->rank);
+			m->bits=NULL;
+			m->rank=NULL;
+		}
+	}
+	else
+		mksorted(m,src);
+
+	return m;
+}
+
+//building the mapping of the IDs of the text, max is the largest ID and ne the number of edges of each chunk (see scantext)
+idmap* mkidmap(textfile *f,int k,unsigned long max,unsigned long *ne){
+	edgesrc src={f,NULL,k};
+	idmap *m;
+	unsigned long e=0;
+	int i;
+
+	for (i=0;i<k;i++)
+		e+=ne[i];
+	m=buildidmap(&src,max,e);
+
+	if (m->n>0 && m->n-1>NODE_MAX)//does not fit in node_t
+		widen();
+
+	return m;
+}
+
+//original IDs of the nodes 0..n-1, NULL if they are the identity
+uint64_t* idmap_ids(idmap *m){
+	uint64_t *ids;
+	unsigned long w;
+
+	if (m->ids!=NULL) {
+		ids=m->ids;
+		m->ids=NULL;
+		return ids;
+	}
+	if (m->bits==NULL)
+		return NULL;
+
+	ids=malloc(m->n*sizeof(uint64_t)+1);
+	#pragma omp parallel for schedule(dynamic,1024)
+	for (w=0;w<=m->max/64;w++) {
+		uint64_t x=m->bits[w],j=m->rank[w];
+		while (x) {
+			ids[j++]=64*w+__builtin_ctzll(x);
+			x&=x-1;
+		}
+	}
+	return ids;
+}
+
+void free_idmap(idmap *m){
+	free(m->bits);
+	free(m->rank);
+	free(m->ids);
+	free(m);
+}
+
+//renumbering the nodes of an edge list 0..n-1 if its IDs are sparse, with the same mapping as for the text
+void compact_edgelist(edgelist *el){
+	edgesrc src={NULL,el,omp_get_max_threads()};
+	idmap *m;
+	unsigned long i,max=0;
+	uint64_t *ids;
+
+	#pragma omp parallel for reduction(max:max)
+	for (i=0;i<el->e;i++) {
+		if (el->edges[i].s>max)
+			max=el->edges[i].s;
+		if (el->edges[i].t>max)
+			max=el->edges[i].t;
+	}
+	m=buildidmap(&src,max,el->e);
+
+	if (m->bits==NULL && m->ids==NULL)//every ID appears, nothing to renumber
+		el->n=m->n;
+	else {
+		#pragma omp parallel for
+		for (i=0;i<el->e;i++) {
+			el->edges[i].s=idmap_get(m,el->edges[i].s);
+			el->edges[i].t=idmap_get(m,el->edges[i].t);
+		}
+		ids=idmap_ids(m);
+		if (el->ids!=NULL) {//the IDs were already renumbered, composing
+			#pragma omp parallel for
+			for (i=0;i<m->n;i++)
+				ids[i]=el->ids[ids[i]];
+			free(el->ids);
+		}
+		el->ids=ids;
+		el->n=m->n;
+	}
+	free_idmap(m);
+}
+
+//node and original ID, sorted by ID in sortbyid
+typedef struct {
+	uint64_t id;
+	node_t u;
+} idnode;
+
+static int cmpidnode(const void *a,const void *b){
+	uint64_t x=((const idnode*)a)->id,y=((const idnode*)b)->id;
+	return (x>y)-(x<y);
+}
+
+//g->byid, the nodes sorted by original ID, for a graph whose IDs are not increasing (see reorder.c)
+void sortbyid(adjlist *g){
+	idnode *a;
+	unsigned long u;
+
+	if (g->ids==NULL || !(g->flags & GRAPH_REORDERED) || g->byid!=NULL)
+		return;
+	a=malloc(g->n*sizeof(idnode)+1);
+	#pragma omp parallel for
+	for (u=0;u<g->n;u++) {
+		a[u].id=g->ids[u];
+		a[u].u=u;
+	}
+	qsort(a,g->n,sizeof(idnode),cmpidnode);
+	g->byid=malloc(g->n*sizeof(node_t)+1);
+	#pragma omp parallel for
+	for (u=0;u<g->n;u++)
+		g->byid[u]=a[u].u;
+	free(a);
+}
+
+//node of original ID x, or NONODE if x is not in the graph (binary search in ids, or in byid if ids is not increasing)
+unsigned long findnode(adjlist *g,uint64_t x){
+	unsigned long a=0,b=g->n,c;
+
+	if (g->ids==NULL)
+		return (x<g->n) ? x : NONODE;
+	if (g->byid!=NULL) {
+		while (a<b) {
+			c=a+(b-a)/2;
+			if (g->ids[g->byid[c]]<x)
+				a=c+1;
+			else
+				b=c;
+		}
+		return (a<g->n && g->ids[g->byid[a]]==x) ? g->byid[a] : NONODE;
+	}
+	while (a<b) {
+		c=a+(b-a)/2;
+		if (g->ids[c]<x)
+			a=c+1;
+		else
+			b=c;
+	}
+	return (a<g->n && g->ids[a]==x) ? a : NONODE;
+}
@@ -0,0 +1,150 @@
+/*
+Info:
+Declarations shared by the files of the library only, the tools include graph.h.
+*/
+
+#ifndef INTERNAL_H
+#define INTERNAL_H
+
+#include <stdlib.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "graph.h"
+
+#define READBUF 16777216 //size of the blocks read when the input cannot be mapped (pipe, stdin)
+
+typedef struct {
+	char *buf;//content of the file
+	size_t len;//length of the file
+	int mapped;//1 if buf comes from mmap, 0 if it was read in a malloc'ed buffer
+	//chunks found while decompressing a compressed file (see zfile.c), cut is NULL otherwise:
+	int k;//number of chunks
+	size_t *cut;//chunk i is buf[cut[i]..cut[i+1]-1]
+	unsigned long *ne;//number of edges of each chunk
+	unsigned long max;//largest ID of the text
+} textfile;
+
+//mapping from the IDs of a text edge list to dense IDs 0..n-1 (see idmap.c)
+typedef struct {
+	unsigned long n;//number of distinct IDs
+	unsigned long max;//largest ID
+	uint64_t *bits;//bitmap of the IDs that appear, NULL if the IDs are sorted in ids or not renumbered
+	uint64_t *rank;//rank[w] is the number of set bits in bits[0..w-1]
+	uint64_t *ids;//sorted distinct IDs, NULL if the bitmap is used or the IDs are not renumbered
+} idmap;
+
+//readedgelist.c
+void openfile(char *input,textfile *f);
+void closefile(textfile *f);
+size_t chunkstart(const textfile *f,int i,int k);
+int nchunks(const textfile *f);
+
+//zfile.c
+int decompress(textfile *f);
+
+//idmap.c
+unsigned long scantext(textfile *f,int k,unsigned long *ne);
+idmap* mkidmap(textfile *f,int k,unsigned long max,unsigned long *ne);
+uint64_t* idmap_ids(idmap *m);
+void free_idmap(idmap *m);
+
+//adjlist.c
+adjlist* newadjlist(unsigned long n,unsigned long e,int directed);
+void prefixsum(offset_t *d,offset_t *cd,unsigned long n);
+void sortlists(adjlist *g);
+
+//per-thread queue of the nodes found by a parallel BFS (see bfs.c and msbfs.c)
+typedef struct {
+	node_t *q;
+	unsigned long len,cap;
+	unsigned long mf;//sum of the degrees of the nodes of q
+	unsigned long edges;//number of edges scanned
+	char pad[64];//the queues of two threads are not on the same cache line
+} localqueue;
+
+static inline void lq_push(localqueue *lq,node_t v){
+	if (lq->len==lq->cap) {
+		lq->cap=(lq->cap==0) ? 4096 : 2*lq->cap;
+		lq->q=realloc(lq->q,lq->cap*sizeof(node_t));
+	}
+	lq->q[lq->len++]=v;
+}
+
+static const char digitpairs[201]=
+	"0001020304050607080910111213141516171819202122232425262728293031323334353637383940414243444546474849"
+	"5051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+
+//writing x in decimal at p, two digits at a time, returns the end (see canon.c and output.c)
+static inline char* putulong(char *p,uint64_t x){
+	char tmp[20];
+	int l=20;
+
+	while (x>=100) {
+		uint64_t q=x/100;
+		memcpy(tmp+(l-=2),digitpairs+2*(x-100*q),2);
+		x=q;
+	}
+	if (x>=10)
+		memcpy(tmp+(l-=2),digitpairs+2*x,2);
+	else
+		tmp[--l]='0'+x;
+	memcpy(p,tmp+l,20-l);
+	return p+20-l;
+}
+
+//dense ID of the original ID x, to be called before idmap_ids
+static inline node_t idmap_get(const idmap *m,unsigned long x){
+	unsigned long a=0,b=m->n,c;
+
+	if (m->bits!=NULL)
+		return m->rank[x>>6]+__builtin_popcountll(m->bits[x>>6] & (((uint64_t)1<<(x&63))-1));
+	if (m->ids==NULL)
+		return x;
+	while (a<b) {
+		c=a+(b-a)/2;
+		if (m->ids[c]<x)
+			a=c+1;
+		else
+			b=c;
+	}
+	return a;
+}
+
+//first byte of the line following position p (or len)
+static inline size_t nextline(const char *buf,size_t len,size_t p){
+	while (p<len && buf[p]!='\n')
+		p++;
+	return (p<len) ? p+1 : len;
+}
+
+//parsing the edge of the line starting at buf[p], returns the start of the next line
+//*ok is set to 1 if an edge was read
+static inline size_t parseline(const char *buf,size_t end,size_t p,unsigned long *s,unsigned long *t,int *ok){
+	unsigned long x;
+	int i;
+
+	*ok=0;
+	while (p<end && (buf[p]==' ' || buf[p]=='\t' || buf[p]=='\r'))
+		p++;
+	if (p<end && (buf[p]=='#' || buf[p]=='%'))
+		return nextline(buf,end,p);
+	for (i=0;i<2;i++) {
+		while (p<end && (buf[p]==' ' || buf[p]=='\t'))
+			p++;
+		if (p==end || buf[p]<'0' || buf[p]>'9')
+			return nextline(buf,end,p);
+		x=0;
+		while (p<end && buf[p]>='0' && buf[p]<='9')
+			x=10*x+(buf[p++]-'0');
+		if (i==0)
+			*s=x;
+		else
+			*t=x;
+	}
+	*ok=1;
+	return nextline(buf,end,p);
+}
+
+#endif
@@ -0,0 +1,414 @@
+/*
+Info:
+Landmark distance index: the distances from k landmarks to every node, stored in a file that is mapped in memory by the programs
+answering distance queries (see ../BFS-triangle/landmarks.c), the graph being no longer needed. The graph is assumed to be undirected.
+For two nodes s and t and a landmark l, the triangle inequality gives |d(l,s)-d(l,t)| <= d(s,t) <= d(l,s)+d(l,t): a query reads
+two rows of k bytes and returns the best lower and upper bounds over the landmarks, in well under a microsecond.
+Optionally, the index also holds a pruned landmark labeling, which gives exact distances.
+
+How it works:
+- the landmarks are the k nodes of largest degree (LM_DEGREE) or k nodes drawn uniformly at random (LM_RANDOM, like centrality.c),
+  one direction-optimizing BFS on all the cores (bfs(), see bfs.c) per landmark;
+- the distances are stored on 8 bits: LM_FAR for 254 or more, LM_NONE if the node cannot be reached from the landmark
+  (a landmark reaching s and not t shows that t cannot be reached from s);
+- the rows are sorted by original ID, so a node given by its ID is found by a binary search in the index itself;
+- labels: pruned landmark labeling (Akiba, Iwata and Yoshida, "Fast exact shortest-path distance queries on large networks
+  by pruned landmark labeling", SIGMOD 2013). A BFS is run from every node by decreasing degree, and adds the pair (root, distance)
+  to the label of every node it reaches, except that it does not go through the nodes whose distance to the root is already
+  given by the labels built so far. d(s,t) is the smallest d(h,s)+d(h,t) over the roots h common to the labels of s and t.
+  The labels have a few hundred entries on social graphs (360 on a Barabasi-Albert graph of 800k edges, built in a few minutes):
+  the construction is sequential and meant for graphs of a few million edges. The distances of the labels are on 8 bits too, so graphs of diameter 255 or more are refused.
+
+Format (native byte order, little-endian on x86), the arrays of 64-bit values being 8-byte aligned:
+- header: magic "CPA-LMK", version, flags (LM_IDS, LM_LABELS), n, k and the total number of label entries;
+- the original IDs of the landmarks: k uint64_t;
+- if LM_IDS, the original IDs of the rows (increasing): n uint64_t, row r is the node of ID r otherwise;
+- the distances: n rows of k bytes, row r holding the distances from the k landmarks to the node of row r;
+- if LM_LABELS, the offsets of the labels of the rows (n+1 uint64_t), the roots of the entries (the rank of the root by degree,
+  uint32_t, increasing within a label) and their distances (bytes).
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "graph.h"
+
+#define LM_MAGIC "CPA-LMK"
+#define LM_VERSION 1
+
+typedef struct {
+	char magic[8];
+	uint32_t version;
+	uint32_t flags;//LM_IDS, LM_LABELS
+	uint64_t n;//number of nodes
+	uint64_t k;//number of landmarks
+	uint64_t nlab;//number of label entries
+} lmheader;
+
+//positions of the arrays in an index file
+typedef struct {
+	uint64_t lm,ids,dist,loff,hub,ldist,end;
+} lmlayout;
+
+//label of a node during the construction
+typedef struct {
+	uint32_t *hub;
+	unsigned char *d;
+	uint32_t len,size;
+} label;
+
+static inline uint64_t align8(uint64_t x){
+	return (x+7)/8*8;
+}
+
+static lmlayout layout(lmheader *h){
+	lmlayout l;
+
+	l.lm=sizeof(lmheader);
+	l.ids=l.lm+h->k*sizeof(uint64_t);
+	l.dist=l.ids+((h->flags & LM_IDS) ? h->n*sizeof(uint64_t) : 0);
+	l.end=l.dist+h->n*h->k;
+	if (h->flags & LM_LABELS) {
+		l.loff=align8(l.end);
+		l.hub=l.loff+(h->n+1)*sizeof(uint64_t);
+		l.ldist=l.hub+h->nlab*sizeof(uint32_t);
+		l.end=l.ldist+h->nlab;
+	}
+	else
+		l.loff=l.hub=l.ldist=l.end;
+	return l;
+}
+
+//k landmarks in lm, by decreasing degree or drawn uniformly
+static void pick(adjlist *g,node_t *rank,unsigned k,int select,unsigned seed,node_t *lm){
+	unsigned long u,i,j;
+
+	if (select==LM_DEGREE) {
+		for (u=0;u<g->n;u++)
+			if (rank[u]<k)
+				lm[rank[u]]=u;
+	}
+	else {//partial Fisher-Yates shuffle
+		node_t *perm=malloc(g->n*sizeof(node_t)),x;
+		unsigned short xs[3];
+		xs[0]=0x330e;
+		xs[1]=seed;
+		xs[2]=seed>>16;
+		for (u=0;u<g->n;u++)
+			perm[u]=u;
+		for (i=0;i<k;i++) {
+			j=i+erand48(xs)*(g->n-i);
+			x=perm[i];
+			perm[i]=perm[j];
+			perm[j]=x;
+			lm[i]=perm[i];
+		}
+		free(perm);
+	}
+}
+
+static void addentry(label *l,uint32_t h,unsigned d){
+	if (l->len==l->size) {
+		l->size=(l->size==0) ? 4 : 2*l->size;
+		l->hub=realloc(l->hub,l->size*sizeof(uint32_t));
+		l->d=realloc(l->d,l->size);
+	}
+	l->hub[l->len]=h;
+	l->d[l->len++]=d;
+}
+
+//pruned landmark labeling, the roots by increasing rank, returns the number of entries
+static unsigned long labeling(adjlist *g,node_t *rank,label *lab){
+	unsigned long n=g->n,i,l,r,nlab=0;
+	node_t *order=malloc(n*sizeof(node_t)),*queue=malloc(n*sizeof(node_t)),w;
+	unsigned char *root=malloc(n);//root[h]: distance from the root to h if h is in its label, 255 otherwise
+	unsigned *dist=malloc(n*sizeof(unsigned)),*stamp=calloc(n,sizeof(unsigned));
+	nbriter it;
+
+	if (n>UINT32_MAX) {
+		fprintf(stderr,"The labels need less than 2^32 nodes\n");
+		exit(1);
+	}
+	for (i=0;i<n;i++)
+		order[rank[i]]=i;
+	memset(root,255,n);
+
+	for (r=0;r<n;r++) {
+		node_t v=order[r];
+		label *lv=lab+v;
+		for (i=0;i<lv->len;i++)
+			root[lv->hub[i]]=lv->d[i];
+		queue[0]=v;
+		stamp[v]=r+1;
+		dist[v]=0;
+		for (i=0,l=1;i<l;i++) {
+			node_t u=queue[i];
+			label *lu=lab+u;
+			unsigned d=dist[u],j;
+			for (j=0;j<lu->len;j++)//pruning: the distance is already known
+				if (root[lu->hub[j]]!=255 && root[lu->hub[j]]+lu->d[j]<=d)
+					break;
+			if (j<lu->len)
+				continue;
+			if (d>=255) {
+				fprintf(stderr,"The labels need a graph of diameter less than 255\n");
+				exit(1);
+			}
+			addentry(lu,r,d);
+			nlab++;
+			forneighbors(g,u,w,it) {
+				if (stamp[w]!=r+1) {
+					stamp[w]=r+1;
+					dist[w]=d+1;
+					queue[l++]=w;
+				}
+			}
+		}
+		for (i=0;i<lv->len;i++)
+			root[lv->hub[i]]=255;
+	}
+
+	free(order);
+	free(queue);
+	free(root);
+	free(dist);
+	free(stamp);
+	return nlab;
+}
+
+//builds the index of g with k landmarks (LM_DEGREE or LM_RANDOM, with the seed for LM_RANDOM) and writes it in output,
+//with the labels for exact distances if labels is not 0, returns the number of label entries
+unsigned long mklandmarks(adjlist *g,unsigned k,int select,unsigned seed,int labels,char *output){
+	unsigned long n=g->n,u,i;
+	node_t *rank,*lm,*row=NULL;
+	const node_t *at=NULL;
+	uint64_t *lmid,*ids=g->ids,zero=0,pad,off;
+	unsigned char *dist;
+	label *lab=NULL;
+	lmheader h;
+	lmlayout l;
+	int ok;
+	FILE *file;
+
+	if (k>n)
+		k=n;
+	rank=mkorder(g,ORDER_DEGREE);
+	lm=malloc(k*sizeof(node_t));
+	pick(g,rank,k,select,seed,lm);
+
+	//rows by increasing original ID: at[r] is the node of row r (g->byid) and row[u] the row of u (the identity unless the graph is reordered)
+	if (g->byid!=NULL) {
+		at=g->byid;
+		row=malloc(n*sizeof(node_t));
+		ids=malloc(n*sizeof(uint64_t));
+		for (i=0;i<n;i++) {
+			row[at[i]]=i;
+			ids[i]=g->ids[at[i]];
+		}
+	}
+
+	dist=malloc(n*k);
+	for (i=0;i<k;i++) {
+		unsigned *d=bfs(g,lm[i]);
+		#pragma omp parallel for
+		for (u=0;u<n;u++) {
+			unsigned long r=(row!=NULL) ? row[u] : u;
+			dist[r*k+i]=(d[u]==(unsigned)-1) ? LM_NONE : (d[u]>=LM_FAR) ? LM_FAR : d[u];
+		}
+	}
+
+	memset(&h,0,sizeof(lmheader));
+	strcpy(h.magic,LM_MAGIC);
+	h.version=LM_VERSION;
+	h.flags=(ids!=NULL) ? LM_IDS : 0;
+	h.n=n;
+	h.k=k;
+	if (labels) {
+		lab=calloc(n,sizeof(label));
+		h.nlab=labeling(g,rank,lab);
+		h.flags|=LM_LABELS;
+	}
+	l=layout(&h);
+
+	file=fopen(output,"wb");
+	if (file==NULL) {
+		fprintf(stderr,"Cannot write %s\n",output);
+		exit(1);
+	}
+	lmid=malloc(k*sizeof(uint64_t));
+	for (i=0;i<k;i++)
+		lmid[i]=nodeid(g,lm[i]);
+	ok=(fwrite(&h,sizeof(lmheader),1,file)==1);
+	ok=ok && (fwrite(lmid,sizeof(uint64_t),k,file)==k);
+	if (ids!=NULL)
+		ok=ok && (fwrite(ids,sizeof(uint64_t),n,file)==n);
+	ok=ok && (fwrite(dist,k,n,file)==n);
+	if (labels) {
+		pad=l.loff-l.dist-n*k;//loff is 8-byte aligned
+		ok=ok && (fwrite(&zero,1,pad,file)==pad);
+		for (i=0,off=0;i<=n && ok;i++) {
+			ok=(fwrite(&off,sizeof(uint64_t),1,file)==1);
+			if (i<n)
+				off+=lab[(at!=NULL) ? at[i] : i].len;
+		}
+		for (i=0;i<n && ok;i++) {
+			label *x=lab+((at!=NULL) ? at[i] : i);
+			ok=(fwrite(x->hub,sizeof(uint32_t),x->len,file)==x->len);
+		}
+		for (i=0;i<n && ok;i++) {
+			label *x=lab+((at!=NULL) ? at[i] : i);
+			ok=(fwrite(x->d,1,x->len,file)==x->len);
+		}
+		for (u=0;u<n;u++) {
+			free(lab[u].hub);
+			free(lab[u].d);
+		}
+		free(lab);
+	}
+	if (!ok || fclose(file)!=0) {
+		fprintf(stderr,"Error while writing %s\n",output);
+		exit(1);
+	}
+
+	free(rank);
+	free(lm);
+	free(lmid);
+	free(dist);
+	free(row);
+	if (ids!=g->ids)
+		free(ids);
+	return h.nlab;
+}
+
+//mapping an index file in memory
+lmindex* maplandmarks(char *input){
+	lmheader h;
+	lmlayout l;
+	struct stat st;
+	lmindex *x;
+	char *map;
+	int fd=open(input,O_RDONLY);
+
+	if (fd<0) {
+		fprintf(stderr,"Cannot read %s\n",input);
+		exit(1);
+	}
+	if (fstat(fd,&st)!=0 || read(fd,&h,sizeof(lmheader))!=sizeof(lmheader) || memcmp(h.magic,LM_MAGIC,sizeof(h.magic))!=0) {
+		fprintf(stderr,"%s is not a landmark index\n",input);
+		exit(1);
+	}
+	if (h.version!=LM_VERSION) {
+		fprintf(stderr,"%s: unsupported index version %u (expected %u), build the index again\n",input,h.version,LM_VERSION);
+		exit(1);
+	}
+	l=layout(&h);
+	if ((uint64_t)st.st_size<l.end) {
+		fprintf(stderr,"%s: truncated index file\n",input);
+		exit(1);
+	}
+
+	map=mmap(NULL,st.st_size,PROT_READ,MAP_SHARED,fd,0);
+	close(fd);
+	if (map==MAP_FAILED) {
+		fprintf(stderr,"Cannot map %s\n",input);
+		exit(1);
+	}
+
+	x=malloc(sizeof(lmindex));
+	x->n=h.n;
+	x->k=h.k;
+	x->flags=h.flags;
+	x->lm=(uint64_t*)(map+l.lm);
+	x->ids=(h.flags & LM_IDS) ? (uint64_t*)(map+l.ids) : NULL;
+	x->dist=(unsigned char*)(map+l.dist);
+	x->loff=(h.flags & LM_LABELS) ? (uint64_t*)(map+l.loff) : NULL;
+	x->hub=(h.flags & LM_LABELS) ? (uint32_t*)(map+l.hub) : NULL;
+	x->ldist=(h.flags & LM_LABELS) ? (unsigned char*)(map+l.ldist) : NULL;
+	x->map=map;
+	x->mapsize=st.st_size;
+	return x;
+}
+
+void free_lmindex(lmindex *x){
+	munmap(x->map,x->mapsize);
+	free(x);
+}
+
+//row of the node of original ID id, NONODE if it is not in the graph
+unsigned long lm_row(lmindex *x,uint64_t id){
+	unsigned long a=0,b=x->n,c;
+
+	if (x->ids==NULL)
+		return (id<x->n) ? id : NONODE;
+	while (a<b) {
+		c=a+(b-a)/2;
+		if (x->ids[c]<id)
+			a=c+1;
+		else
+			b=c;
+	}
+	return (a<x->n && x->ids[a]==id) ? a : NONODE;
+}
+
+//bounds lo<=d(s,t)<=hi for the nodes of rows s and t: lo=hi=-1 when a landmark proves t unreachable (it reaches only one of them),
+//otherwise hi=-1 only means the bound is unknown (no landmark reaches both, e.g. s and t in components without landmark)
+void lm_bounds(lmindex *x,unsigned long s,unsigned long t,unsigned *lo,unsigned *hi){
+	const unsigned char *a=x->dist+s*x->k,*b=x->dist+t*x->k;
+	unsigned long i;
+	unsigned l=1,h=-1;
+
+	if (s==t) {
+		*lo=*hi=0;
+		return;
+	}
+	for (i=0;i<x->k;i++) {
+		unsigned da=a[i],db=b[i];
+		if (da==LM_NONE || db==LM_NONE) {
+			if (da!=db) {//one of them is reached by the landmark and not the other one
+				*lo=*hi=-1;
+				return;
+			}
+			continue;
+		}
+		if (da<LM_FAR && db<LM_FAR) {
+			if (da+db<h)
+				h=da+db;
+			if (da>db && da-db>l)
+				l=da-db;
+			else if (db>da && db-da>l)
+				l=db-da;
+		}
+		else if (da<LM_FAR && LM_FAR-da>l)//db is LM_FAR or more
+			l=LM_FAR-da;
+		else if (db<LM_FAR && LM_FAR-db>l)
+			l=LM_FAR-db;
+	}
+	*lo=l;
+	*hi=h;
+}
+
+//exact distance between the nodes of rows s and t with the labels (-1 if t cannot be reached from s)
+unsigned lm_exact(lmindex *x,unsigned long s,unsigned long t){
+	uint64_t i=x->loff[s],ie=x->loff[s+1],j=x->loff[t],je=x->loff[t+1];
+	unsigned d=-1;
+
+	while (i<ie && j<je) {
+		if (x->hub[i]<x->hub[j])
+			i++;
+		else if (x->hub[i]>x->hub[j])
+			j++;
+		else {
+			if ((unsigned)x->ldist[i]+x->ldist[j]<d)
+				d=x->ldist[i]+x->ldist[j];
+			i++;
+			j++;
+		}
+	}
+	return d;
+}
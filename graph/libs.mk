@@ -0,0 +1,7 @@
+# libraries needed by the programs linked with libgraph: zlib and libbz2 for compressed edge lists (see zfile.c), zstd when it is installed
+ZLIBS=-lz -lbz2 -lpthread
+ZFLAGS=
+ifneq ($(wildcard /usr/include/zstd.h),)
+ZFLAGS=-DHAVE_ZSTD
+ZLIBS+=-lzstd
+endif
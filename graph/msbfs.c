@@ -0,0 +1,233 @@
+/*
+Info:
+Multi-source BFS (Then et al., "The more the merrier: efficient multi-source graph traversal", VLDB 2015), the graph is assumed to be undirected.
+Up to MS_SOURCES sources are searched at once: every node has three masks of one bit per source, seen (sources that reached it),
+visit (sources whose frontier contains it) and next (sources that reach it at the next level), so every edge is scanned once per level
+for the whole batch instead of once per source, and the masks are combined with word-wide operations.
+The masks take w=ceil(ns/64) words per node for ns sources: the workspace (msctx) takes 24w+13 bytes per node (24w+25 with 64-bit
+nodes), 37 bytes for up to 64 sources. It is allocated once and reused by the batches: a search leaves every mask at zero,
+visit and next being cleared level by level and seen only on the nodes it reached (done), so nothing of size n is reset.
+
+How it works:
+Each level is built in one of two directions, as in bfs.c:
+- push (top-down): the nodes of the frontier OR their visit mask into the next mask of their neighbors (atomic OR),
+  the nodes reached for the first time are collected in per-thread queues;
+- pull (bottom-up): every node not yet reached by all the sources ORs the visit masks of its neighbors, it needs no synchronization.
+The search pulls when the edges of the frontier exceed the edges of the nodes not reached by all the sources divided by MS_ALPHA.
+Then the new bits of every touched node are the sources that reach it at distance d: d times their number is added to sumdist
+and their number to reach, which is what the closeness centrality needs, without a distance array per source.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <omp.h>
+
+#include "graph.h"
+#include "internal.h"
+
+#define MSW (MS_SOURCES/64) //largest number of 64-bit words of a mask
+#define MS_ALPHA 14
+
+//copying the per-thread queues one after the other in dst, returns the total length
+static unsigned long gather(localqueue *lq,int nt,node_t *dst){
+	unsigned long l=0,len;
+	int t;
+
+	for (t=0;t<nt;t++) {
+		len=lq[t].len;
+		lq[t].len=l;//position of the queue of t in dst
+		l+=len;
+	}
+	#pragma omp parallel for num_threads(nt) schedule(static,1)
+	for (t=0;t<nt;t++) {
+		unsigned long end=(t+1<nt) ? lq[t+1].len : l;
+		memcpy(dst+lq[t].len,lq[t].q,(end-lq[t].len)*sizeof(node_t));
+	}
+	return l;
+}
+
+//workspace for searches of at most ns sources
+msctx* mkmsctx(adjlist *g,int ns){
+	msctx *c=malloc(sizeof(msctx));
+
+	if (ns<1 || ns>MS_SOURCES) {
+		fprintf(stderr,"A multi-source BFS has 1 to %d sources\n",MS_SOURCES);
+		exit(1);
+	}
+	c->n=g->n;
+	c->w=(ns+63)/64;
+	c->seen=galloc(g->n*c->w*sizeof(uint64_t),"seen");
+	c->visit=galloc(g->n*c->w*sizeof(uint64_t),"visit");
+	c->next=galloc(g->n*c->w*sizeof(uint64_t),"next");
+	c->front=galloc(g->n*sizeof(node_t),"frontier");
+	c->cand=galloc(g->n*sizeof(node_t),"touched");
+	c->done=galloc(g->n*sizeof(node_t),"reached");
+	c->mark=galloc(g->n,"mark");
+	return c;
+}
+
+void free_msctx(msctx *c){
+	gfree(c->seen);
+	gfree(c->visit);
+	gfree(c->next);
+	gfree(c->front);
+	gfree(c->cand);
+	gfree(c->done);
+	gfree(c->mark);
+	free(c);
+}
+
+//BFS from the ns nodes of src at once in the workspace c (made for at least ns sources)
+//for every node v, adds the sum of its distances to the sources that reach it to sumdist[v] and the number of these sources to reach[v]
+void msbfs(adjlist *g,msctx *c,const node_t *src,int ns,unsigned long *sumdist,unsigned *reach){
+	unsigned long n=g->n,nf=0,nc,nd,mf=0,mu=g->cd[n],i;
+	uint64_t *seen=c->seen,*visit=c->visit,*next=c->next;
+	uint64_t full[MSW];
+	node_t *front=c->front,*cand=c->cand,*done=c->done;
+	unsigned char *mark=c->mark;
+	int nt=omp_get_max_threads(),t,W=(ns+63)/64;//words of the masks of this search
+	localqueue *lq=calloc(nt,sizeof(localqueue));
+	unsigned d;
+
+	if (ns<1 || W>c->w) {
+		fprintf(stderr,"The workspace of the multi-source BFS is made for at most %d sources\n",64*c->w);
+		exit(1);
+	}
+	memset(full,0,sizeof(full));
+	for (i=0;i<(unsigned long)ns;i++) {
+		node_t s=src[i];
+		full[i/64]|=(uint64_t)1<<(i%64);
+		seen[s*W+i/64]|=(uint64_t)1<<(i%64);
+		visit[s*W+i/64]|=(uint64_t)1<<(i%64);
+		reach[s]++;
+		if (!mark[s]) {
+			mark[s]=1;
+			front[nf++]=s;
+			mf+=g->cd[s+1]-g->cd[s];
+		}
+	}
+	for (i=0;i<nf;i++) {
+		mark[front[i]]=0;
+		done[i]=front[i];
+	}
+	nd=nf;
+
+	for (d=1;nf>0;d++) {
+		int pull=(mf>mu/MS_ALPHA);
+		unsigned long dmf=0,dmu=0;
+
+		for (t=0;t<nt;t++)
+			lq[t].len=0;
+		#pragma omp parallel num_threads(nt)
+		{
+			localqueue *q=lq+omp_get_thread_num();
+			unsigned long j,v;
+			nbriter it;
+			node_t w;
+			int k;
+
+			if (!pull) {
+				#pragma omp for schedule(dynamic,64)
+				for (j=0;j<nf;j++) {
+					const uint64_t *x=visit+(unsigned long)front[j]*W;
+					forneighbors(g,front[j],w,it) {
+						uint64_t *y=next+(unsigned long)w*W;
+						const uint64_t *z=seen+(unsigned long)w*W;
+						int any=0;
+						for (k=0;k<W;k++) {
+							uint64_t b=x[k] & ~z[k];
+							if (b & ~y[k]) {
+								__atomic_fetch_or(y+k,b,__ATOMIC_RELAXED);
+								any=1;
+							}
+						}
+						if (any && !mark[w] && __sync_bool_compare_and_swap(mark+w,0,1))
+							lq_push(q,w);
+					}
+				}
+			}
+			else {
+				#pragma omp for schedule(dynamic,1024)
+				for (v=0;v<n;v++) {
+					const uint64_t *z=seen+v*W;
+					uint64_t acc[MSW],any=0;
+					for (k=0;k<W;k++) {
+						acc[k]=0;
+						any|=full[k] & ~z[k];
+					}
+					if (!any)//reached by all the sources
+						continue;
+					forneighbors(g,v,w,it) {
+						const uint64_t *x=visit+(unsigned long)w*W;
+						for (k=0;k<W;k++)
+							acc[k]|=x[k];
+					}
+					any=0;
+					for (k=0;k<W;k++) {
+						acc[k]&=~z[k];
+						any|=acc[k];
+					}
+					if (any) {
+						memcpy(next+v*W,acc,W*sizeof(uint64_t));
+						lq_push(q,v);
+					}
+				}
+			}
+
+			//the frontier is over
+			#pragma omp for
+			for (j=0;j<nf;j++)
+				memset(visit+(unsigned long)front[j]*W,0,W*sizeof(uint64_t));
+		}
+		nc=gather(lq,nt,cand);
+
+		//new sources of every touched node, they reach it at distance d
+		for (t=0;t<nt;t++)
+			lq[t].len=0;
+		#pragma omp parallel num_threads(nt) reduction(+:dmf,dmu)
+		{
+			localqueue *q=lq+omp_get_thread_num();
+			unsigned long j;
+			int k;
+
+			#pragma omp for schedule(dynamic,1024)
+			for (j=0;j<nc;j++) {
+				node_t v=cand[j];
+				uint64_t *x=next+(unsigned long)v*W,*y=visit+(unsigned long)v*W,*z=seen+(unsigned long)v*W,rest=0,old=0;
+				unsigned cnt=0;
+				for (k=0;k<W;k++) {
+					old|=z[k];
+					y[k]=x[k] & ~z[k];
+					x[k]=0;
+					z[k]|=y[k];
+					cnt+=__builtin_popcountll(y[k]);
+					rest|=full[k] & ~z[k];
+				}
+				mark[v]=0;
+				if (cnt==0)
+					continue;
+				if (!old)//reached for the first time
+					done[__atomic_fetch_add(&nd,1,__ATOMIC_RELAXED)]=v;
+				sumdist[v]+=(unsigned long)d*cnt;
+				reach[v]+=cnt;
+				lq_push(q,v);
+				dmf+=g->cd[v+1]-g->cd[v];
+				if (!rest)//reached by all the sources now
+					dmu+=g->cd[v+1]-g->cd[v];
+			}
+		}
+		nf=gather(lq,nt,front);
+		mf=dmf;
+		mu-=dmu;
+	}
+
+	//the next search starts from zero masks
+	#pragma omp parallel for num_threads(nt)
+	for (i=0;i<nd;i++)
+		memset(seen+(unsigned long)done[i]*W,0,W*sizeof(uint64_t));
+
+	for (t=0;t<nt;t++)
+		free(lq[t].q);
+	free(lq);
+}
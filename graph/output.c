@@ -0,0 +1,214 @@
+/*
+Info:
+Output of one value per node ("nodeID value" on each line), shared by the tools (bfs, centrality, closeness, proplabel...).
+With fprintf, formatting a file of 100M lines takes longer than most of the computations that produced it.
+
+How it works:
+The nodes are cut in blocks of OUT_BLOCK consecutive nodes. In each round, every thread formats one block in its own buffer
+with hand-rolled conversions (integers two digits at a time, doubles in the "%e" format of printf), then the buffers are
+written in the order of the blocks with a single fwrite each. The memory used is a few MB per thread whatever the size of the graph.
+The doubles are printed like printf("%e"): the 7 significant digits are obtained by a multiplication or division by a power
+of 10 in long double (the powers up to 10^27 are exact) and rounded half to even. The product is itself rounded to the 64-bit mantissa,
+so when the discarded part is within OUT_TIE of one half the rounding could go the other way than printf's exact one: these values,
+and the others (outside [1e-21,1e33], inf, nan), use snprintf.
+
+With the environment variable GRAPH_OUTPUT=binary, the values are written as raw arrays instead, in native byte order (little-endian on x86):
+- header: magic "CPA-VAL", version, type of the values (VAL_*), n, and 1 if the original IDs follow (0 if the IDs are 0..n-1);
+- the original IDs if any: n uint64_t;
+- the values: n uint32_t (VAL_U32), uint64_t (VAL_U64) or double (VAL_F64).
+
+The query files of ./distance and ./lmquery ("s t" on each line) are read here too, by batches of QUERY_BATCH (readqueries).
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>//signbit and isfinite macros only, no -lm
+#include <omp.h>
+
+#include "graph.h"
+#include "internal.h"
+
+#define OUT_BLOCK 65536 //nodes formatted by a thread at once
+#define OUT_LINE 64 //longest line: two 20-digit integers, or an integer and a double
+#define OUT_TIE 1e-9L //discarded part closer than this to one half: formatted by snprintf
+#define VAL_MAGIC "CPA-VAL"
+#define VAL_VERSION 1
+#define QUERY_LINE 1024 //longest line of a query file
+
+typedef struct {
+	char magic[8];
+	uint32_t version;
+	uint32_t type;//VAL_*
+	uint64_t n;//number of nodes
+	uint64_t ids;//1 if the original IDs follow the header
+} valheader;
+
+static long double pow10l_(int k){
+	long double r=1;
+	while (k-->0)
+		r*=10;
+	return r;
+}
+
+//x as printf("%e") at p, returns the position after it
+static char* putdouble(char *p,double x){
+	long double m,s;
+	unsigned long d;
+	char tmp[8],*start=p;
+	double x0=x;
+	int e,k;
+
+	if (x==0) {
+		memcpy(p,signbit(x) ? "-0.000000e+00" : "0.000000e+00",signbit(x) ? 13 : 12);
+		return p+(signbit(x) ? 13 : 12);
+	}
+	if (!isfinite(x) || (x>-1e-21 && x<1e-21) || x>=1e33 || x<=-1e33)
+		return p+snprintf(p,OUT_LINE,"%e",x);
+	if (x<0) {
+		*p++='-';
+		x=-x;
+	}
+	//estimate of the exponent, it can be one off
+	for (e=0,m=x;m>=10;e++)
+		m/=10;
+	for (;m<1;e--)
+		m*=10;
+	for (k=0;k<2;k++) {
+		s=pow10l_((e>=6) ? e-6 : 6-e);
+		m=(e>=6) ? (long double)x/s : (long double)x*s;
+		d=(unsigned long)m;
+		m-=d;
+		if (m-0.5L<OUT_TIE && 0.5L-m<OUT_TIE)//too close to a tie to decide in long double
+			return start+snprintf(start,OUT_LINE,"%e",x0);
+		if (m>0.5L || (m==0.5L && (d&1)))//half to even, like printf
+			d++;
+		if (d>=10000000)
+			e++;
+		else if (d<1000000)
+			e--;
+		else
+			break;
+	}
+	if (d>=10000000) {//rounding up to the next power of 10
+		d/=10;
+		e++;
+	}
+	putulong(tmp,d);//7 digits
+	p[0]=tmp[0];
+	p[1]='.';
+	memcpy(p+2,tmp+1,6);
+	p+=8;
+	*p++='e';
+	*p++=(e<0) ? '-' : '+';
+	e=abs(e);
+	if (e<10)
+		*p++='0';
+	return putulong(p,e);
+}
+
+static int binarymode(void){
+	char *env=getenv("GRAPH_OUTPUT");
+	return env!=NULL && strcmp(env,"binary")==0;
+}
+
+static void writebinary(adjlist *g,const void *val,int type,FILE *file,int *ok){
+	valheader h;
+	size_t w=(type==VAL_U32) ? 4 : 8;
+
+	memset(&h,0,sizeof(valheader));
+	strcpy(h.magic,VAL_MAGIC);
+	h.version=VAL_VERSION;
+	h.type=type;
+	h.n=g->n;
+	h.ids=(g->ids!=NULL);
+	*ok=(fwrite(&h,sizeof(valheader),1,file)==1);
+	if (g->ids!=NULL)
+		*ok=*ok && (fwrite(g->ids,sizeof(uint64_t),g->n,file)==g->n);
+	*ok=*ok && (fwrite(val,w,g->n,file)==g->n);
+}
+
+//"nodeID value" for every node in output ("-" for the standard output), val being an array of n values of type VAL_*
+void writevalues(adjlist *g,const void *val,int type,char *output){
+	int tostdout=(strcmp(output,"-")==0),nt=omp_get_max_threads(),ok=1;
+	FILE *file=tostdout ? stdout : fopen(output,"w");
+	char **buf;
+	size_t *len;
+	unsigned long start;
+
+	if (file==NULL) {
+		fprintf(stderr,"Cannot write %s\n",output);
+		exit(1);
+	}
+	if (binarymode())
+		writebinary(g,val,type,file,&ok);
+	else {
+		int t;
+		buf=malloc(nt*sizeof(char*));
+		len=malloc(nt*sizeof(size_t));
+		for (t=0;t<nt;t++)
+			buf[t]=malloc(OUT_BLOCK*OUT_LINE);
+		for (start=0;start<g->n;start+=(unsigned long)nt*OUT_BLOCK) {
+			#pragma omp parallel for num_threads(nt) schedule(static,1)
+			for (t=0;t<nt;t++) {
+				unsigned long u=start+(unsigned long)t*OUT_BLOCK,end=u+OUT_BLOCK;
+				char *p=buf[t];
+				if (end>g->n)
+					end=g->n;
+				for (;u<end;u++) {
+					p=putulong(p,nodeid(g,u));
+					*p++=' ';
+					if (type==VAL_U32)
+						p=putulong(p,((const uint32_t*)val)[u]);
+					else if (type==VAL_U64)
+						p=putulong(p,((const uint64_t*)val)[u]);
+					else
+						p=putdouble(p,((const double*)val)[u]);
+					*p++='\n';
+				}
+				len[t]=p-buf[t];
+			}
+			for (t=0;t<nt;t++)
+				ok=ok && (fwrite(buf[t],1,len[t],file)==len[t]);
+		}
+		for (t=0;t<nt;t++)
+			free(buf[t]);
+		free(buf);
+		free(len);
+	}
+	if (tostdout)
+		ok=ok && (fflush(file)==0);
+	else
+		ok=(fclose(file)==0) && ok;
+	if (!ok) {
+		fprintf(stderr,"Error while writing %s\n",output);
+		exit(1);
+	}
+}
+
+//reads at most QUERY_BATCH queries "s t" (original IDs) of a query file in qs and qt, returns their number
+//line counts the lines read, for the error messages, and the lines starting with '#' or '%' are skipped
+unsigned long readqueries(FILE *file,uint64_t *qs,uint64_t *qt,unsigned long *line){
+	char buf[QUERY_LINE],*p,*q;
+	unsigned long nq=0;
+
+	while (nq<QUERY_BATCH && fgets(buf,QUERY_LINE,file)!=NULL) {
+		(*line)++;
+		for (p=buf;*p==' ' || *p=='\t';p++);
+		if (*p=='#' || *p=='%' || *p=='\n' || *p=='\r' || *p=='\0')
+			continue;
+		qs[nq]=strtoull(p,&q,10);
+		if (q==p) {
+			fprintf(stderr,"Wrong query on line %lu\n",*line);
+			exit(1);
+		}
+		p=q;
+		qt[nq]=strtoull(p,&q,10);
+		if (q==p) {
+			fprintf(stderr,"Wrong query on line %lu\n",*line);
+			exit(1);
+		}
+		nq++;
+	}
+	return nq;
+}
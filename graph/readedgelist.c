@@ -0,0 +1,154 @@
+/*
+Info:
+Parallel loader for text edge lists: one edge per line, two unsigned long (nodes' ID) separated by spaces or tabs.
+Anything after the two IDs on a line is ignored (e.g. weights) and lines starting with '#' or '%' are comments.
+
+How it works:
+The file is mapped in memory with mmap and split into one chunk per thread, each chunk boundary being moved to the next end of line.
+A first parallel scan counts the edges of every chunk and finds the largest ID, so that sparse IDs can be compacted (see idmap.c).
+Every thread then parses its chunks with a hand-written tokenizer directly into the final edge array, at the position given by a prefix sum of the counts,
+so there is neither a serial chain of realloc nor per-thread buffers to merge.
+Compressed files (gzip, bzip2, zstd) are decompressed in memory first (see zfile.c), their chunks are then the ones found while decompressing.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <omp.h>
+
+#include "graph.h"
+#include "internal.h"
+
+//reading the whole stream in memory, used when mmap is not possible
+static void slurp(int fd,textfile *f){
+	size_t size=READBUF;
+	ssize_t r;
+
+	f->buf=malloc(size);
+	f->len=0;
+	while ((r=read(fd,f->buf+f->len,size-f->len))>0) {
+		f->len+=r;
+		if (f->len==size) {
+			size*=2;
+			f->buf=realloc(f->buf,size);
+		}
+	}
+	f->mapped=0;
+}
+
+//mapping the file in memory ("-" is the standard input)
+void openfile(char *input,textfile *f){
+	struct stat st;
+	int fd=(strcmp(input,"-")==0) ? 0 : open(input,O_RDONLY);
+
+	if (fd<0) {
+		fprintf(stderr,"Cannot open %s\n",input);
+		exit(1);
+	}
+	f->buf=NULL;
+	f->len=0;
+	f->mapped=0;
+	f->k=0;
+	f->cut=NULL;
+	f->ne=NULL;
+	if (fstat(fd,&st)==0 && S_ISREG(st.st_mode)) {
+		f->len=st.st_size;
+		if (f->len>0) {
+			f->buf=mmap(NULL,f->len,PROT_READ,MAP_PRIVATE,fd,0);
+			if (f->buf==MAP_FAILED)
+				slurp(fd,f);
+			else {
+				madvise(f->buf,f->len,MADV_SEQUENTIAL);
+				f->mapped=1;
+			}
+		}
+	}
+	else
+		slurp(fd,f);
+	if (fd!=0)
+		close(fd);
+	decompress(f);
+}
+
+void closefile(textfile *f){
+	if (f->mapped)
+		munmap(f->buf,f->len);
+	else
+		free(f->buf);
+	free(f->cut);
+	free(f->ne);
+}
+
+//number of chunks of the text: one per thread, or the chunks found while decompressing
+int nchunks(const textfile *f){
+	return (f->cut!=NULL) ? f->k : omp_get_max_threads();
+}
+
+//start of the i-th of k chunks, aligned on the beginning of a line
+size_t chunkstart(const textfile *f,int i,int k){
+	size_t p;
+	if (f->cut!=NULL)
+		return f->cut[i];
+	if (i==0)
+		return 0;
+	if (i==k)
+		return f->len;
+	p=(f->len/k)*i;
+	return (p==0) ? 0 : nextline(f->buf,f->len,p-1);
+}
+
+//reading the edgelist from file
+edgelist* readedgelist(char* input){
+	textfile f;
+	edgelist *el=malloc(sizeof(edgelist));
+	idmap *m;
+	int k,i;
+	unsigned long *ne,max;
+
+	openfile(input,&f);
+	k=nchunks(&f);
+	ne=malloc((k+1)*sizeof(unsigned long));
+
+	max=scantext(&f,k,ne+1);
+	m=mkidmap(&f,k,max,ne+1);
+	ne[0]=0;
+	for (i=0;i<k;i++)//ne[i] is now the position of the edges of chunk i
+		ne[i+1]+=ne[i];
+
+	el->n=m->n;
+	el->e=ne[k];
+	el->edges=malloc(el->e*sizeof(edge));
+
+	#pragma omp parallel for schedule(dynamic,1)
+	for (i=0;i<k;i++) {
+		size_t p=chunkstart(&f,i,k),end=chunkstart(&f,i+1,k);
+		unsigned long s,t,e=ne[i];
+		int ok;
+
+		while (p<end) {
+			p=parseline(f.buf,end,p,&s,&t,&ok);
+			if (!ok)
+				continue;
+			el->edges[e].s=idmap_get(m,s);
+			el->edges[e].t=idmap_get(m,t);
+			e++;
+		}
+	}
+	closefile(&f);
+
+	el->ids=idmap_ids(m);
+	free_idmap(m);
+	free(ne);
+
+	return el;
+}
+
+void free_edgelist(edgelist *el){
+	free(el->edges);
+	free(el->ids);
+	free(el);
+}
@@ -0,0 +1,285 @@
+/*
+Info:
+Renumbering the nodes to improve the locality of the accesses to per-node arrays (dist, label, PageRank...) through adj.
+Neighbors get close IDs, so that they share cache lines and pages.
+
+Orders:
+- ORDER_DEGREE: decreasing degree, the hubs (which are accessed most often) are packed at the beginning of the arrays;
+- ORDER_RCM: reverse Cuthill-McKee, a BFS from a pseudo-peripheral node of every connected component visiting the neighbors by increasing degree, then reversed;
+  neighbors get close IDs and the bandwidth of the adjacency matrix is small (which also makes the gaps of compress.c small);
+- ORDER_GORDER: greedy windowed order in the spirit of Gorder (Wei et al., SIGMOD 2016): the next node is the one with the highest score
+  with the last GORDER_WINDOW placed nodes, the score of v with u being 1 if they are neighbors plus their number of common neighbors.
+  Scores are kept in buckets (unit increments and decrements), and the lists of hubs are not expanded when counting common neighbors.
+  This order is sequential and the slowest to compute, but it usually gives the fewest cache misses.
+
+mkorder() returns rank (rank[u] is the new ID of u) and permute_adjlist() builds the renumbered adjacency list,
+the original IDs are composed into ids so that the results are still written with the IDs of the input file.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <omp.h>
+
+#include "graph.h"
+#include "internal.h"
+
+#define GORDER_WINDOW 5
+
+static inline offset_t degree(adjlist *g,unsigned long u){
+	return g->cd[u+1]-g->cd[u];
+}
+
+//nodes sorted by decreasing degree (by increasing ID for equal degrees), with a counting sort
+static node_t* bydegree(adjlist *g){
+	unsigned long u,maxd=0,*pos;
+	node_t *list=malloc(g->n*sizeof(node_t));
+
+	for (u=0;u<g->n;u++)
+		if (degree(g,u)>maxd)
+			maxd=degree(g,u);
+	pos=calloc(maxd+2,sizeof(unsigned long));
+	for (u=0;u<g->n;u++)
+		pos[maxd-degree(g,u)+1]++;
+	for (u=0;u<=maxd;u++)
+		pos[u+1]+=pos[u];
+	for (u=0;u<g->n;u++)
+		list[pos[maxd-degree(g,u)]++]=u;
+	free(pos);
+	return list;
+}
+
+typedef struct {
+	offset_t d;
+	node_t v;
+} nodedeg;
+
+static int cmpdeg(const void *a,const void *b){
+	const nodedeg *x=a,*y=b;
+	if (x->d!=y->d)
+		return (x->d>y->d)-(x->d<y->d);
+	return (x->v>y->v)-(x->v<y->v);
+}
+
+//Cuthill-McKee order of the component of root, appended to list from position l, returns the new length
+//mark[v]==stamp for the nodes already visited
+static unsigned long cuthillmckee(adjlist *g,unsigned long root,unsigned long l,node_t *list,unsigned *mark,unsigned stamp,nodedeg *buf){
+	unsigned long i=l,k,j;
+	nbriter it;
+	node_t v;
+
+	list[l++]=root;
+	mark[root]=stamp;
+	for (;i<l;i++) {
+		k=0;
+		forneighbors(g,list[i],v,it) {
+			if (mark[v]!=stamp) {
+				mark[v]=stamp;
+				buf[k].d=degree(g,v);
+				buf[k++].v=v;
+			}
+		}
+		qsort(buf,k,sizeof(nodedeg),cmpdeg);
+		for (j=0;j<k;j++)
+			list[l++]=buf[j].v;
+	}
+	return l;
+}
+
+//reverse Cuthill-McKee, the root of each component is the last node reached by a Cuthill-McKee BFS
+//started from its node of smallest degree (one step of the George-Liu pseudo-peripheral node search)
+static node_t* rcm(adjlist *g){
+	node_t *bydeg=bydegree(g),*list=malloc(g->n*sizeof(node_t)),*rank=malloc(g->n*sizeof(node_t));
+	unsigned *mark=calloc(g->n,sizeof(unsigned));
+	nodedeg *buf=malloc((g->n+1)*sizeof(nodedeg));
+	unsigned long i,l=0,b,root;
+	unsigned stamp=0;
+
+	for (i=g->n;i>0;i--) {//from the smallest degree
+		root=bydeg[i-1];
+		if (mark[root]!=0)
+			continue;
+		//finding a pseudo-peripheral node: BFS of the component with a temporary stamp
+		stamp+=2;
+		b=cuthillmckee(g,root,l,list,mark,stamp-1,buf);
+		root=list[b-1];//last node of the BFS, it belongs to the last level
+		//the real order, mark is overwritten with the final stamp
+		l=cuthillmckee(g,root,l,list,mark,stamp,buf);
+	}
+
+	for (i=0;i<g->n;i++)//reversing
+		rank[list[i]]=g->n-1-i;
+
+	free(bydeg);
+	free(list);
+	free(mark);
+	free(buf);
+	return rank;
+}
+
+//bucket structure of the Gorder scores: doubly linked list of the unplaced nodes of each score
+typedef struct {
+	unsigned long *key;
+	node_t *next,*prev;
+	node_t *head;
+	unsigned long nk;//number of buckets
+	unsigned long top;//no non-empty bucket above top
+} buckets;
+
+#define NIL NODE_MAX
+
+static inline void bk_remove(buckets *b,node_t v){
+	if (b->prev[v]!=NIL)
+		b->next[b->prev[v]]=b->next[v];
+	else
+		b->head[b->key[v]]=b->next[v];
+	if (b->next[v]!=NIL)
+		b->prev[b->next[v]]=b->prev[v];
+}
+
+static inline void bk_push(buckets *b,node_t v){
+	unsigned long i;
+
+	if (b->key[v]>=b->nk) {//possible with multiple edges or directed graphs
+		b->head=realloc(b->head,2*b->key[v]*sizeof(node_t));
+		for (i=b->nk;i<2*b->key[v];i++)
+			b->head[i]=NIL;
+		b->nk=2*b->key[v];
+	}
+	b->prev[v]=NIL;
+	b->next[v]=b->head[b->key[v]];
+	if (b->next[v]!=NIL)
+		b->prev[b->next[v]]=v;
+	b->head[b->key[v]]=v;
+	if (b->key[v]>b->top)
+		b->top=b->key[v];
+}
+
+static inline void bk_add(buckets *b,node_t v,int delta){
+	bk_remove(b,v);
+	b->key[v]+=delta;
+	bk_push(b,v);
+}
+
+//adding delta to the scores of the unplaced nodes with u: its neighbors and the neighbors of its (non-hub) neighbors
+static void gorder_update(adjlist *g,buckets *b,char *placed,unsigned long u,int delta,offset_t hub){
+	nbriter it,it2;
+	node_t v,x;
+
+	forneighbors(g,u,v,it) {
+		if (!placed[v])
+			bk_add(b,v,delta);
+		if (degree(g,v)>hub)
+			continue;
+		forneighbors(g,v,x,it2) {
+			if (x!=u && !placed[x])
+				bk_add(b,x,delta);
+		}
+	}
+}
+
+static node_t* gorder(adjlist *g){
+	node_t *bydeg=bydegree(g),*list=malloc(g->n*sizeof(node_t)),*rank=malloc(g->n*sizeof(node_t)),u;
+	char *placed=calloc(g->n,1);
+	offset_t hub=1,maxd=0;
+	unsigned long i;
+	buckets b;
+
+	while (hub*hub<g->n)//lists longer than sqrt(n) are not expanded
+		hub++;
+	if (g->n>0)
+		maxd=degree(g,bydeg[0]);
+	b.nk=GORDER_WINDOW*(maxd+1)+1;//largest score of a simple undirected graph plus one
+	b.key=calloc(g->n,sizeof(unsigned long));
+	b.next=malloc(g->n*sizeof(node_t));
+	b.prev=malloc(g->n*sizeof(node_t));
+	b.head=malloc(b.nk*sizeof(node_t));
+	for (i=0;i<b.nk;i++)
+		b.head[i]=NIL;
+	b.top=0;
+	for (i=g->n;i>0;i--)//the head of bucket 0 is the node of largest degree
+		bk_push(&b,bydeg[i-1]);
+
+	for (i=0;i<g->n;i++) {
+		while (b.head[b.top]==NIL)
+			b.top--;
+		u=b.head[b.top];
+		bk_remove(&b,u);
+		placed[u]=1;
+		list[i]=u;
+		gorder_update(g,&b,placed,u,1,hub);
+		if (i>=GORDER_WINDOW)//the oldest node leaves the window
+			gorder_update(g,&b,placed,list[i-GORDER_WINDOW],-1,hub);
+	}
+
+	#pragma omp parallel for
+	for (i=0;i<g->n;i++)
+		rank[list[i]]=i;
+
+	free(bydeg);
+	free(list);
+	free(placed);
+	free(b.key);
+	free(b.next);
+	free(b.prev);
+	free(b.head);
+	return rank;
+}
+
+//new ID of every node in the given order (ORDER_*)
+node_t* mkorder(adjlist *g,int order){
+	node_t *list,*rank;
+	unsigned long i;
+
+	switch (order) {
+		case ORDER_DEGREE:
+			list=bydegree(g);
+			rank=malloc(g->n*sizeof(node_t));
+			#pragma omp parallel for
+			for (i=0;i<g->n;i++)
+				rank[list[i]]=i;
+			free(list);
+			return rank;
+		case ORDER_RCM:
+			return rcm(g);
+		case ORDER_GORDER:
+			return gorder(g);
+	}
+	fprintf(stderr,"Unknown order %d\n",order);
+	exit(1);
+}
+
+//renumbered copy of the adjacency list, node u becomes rank[u], the lists of neighbors are sorted again
+adjlist* permute_adjlist(adjlist *g,node_t *rank){
+	adjlist *h=newadjlist(g->n,g->e,g->flags & GRAPH_DIRECTED);
+	offset_t *d=malloc((g->n+1)*sizeof(offset_t));
+	unsigned long u;
+
+	#pragma omp parallel for
+	for (u=0;u<g->n;u++)
+		d[rank[u]]=degree(g,u);
+	h->cd=galloc((g->n+1)*sizeof(offset_t),"cd");
+	prefixsum(d,h->cd,g->n);
+	free(d);
+
+	h->adj=galloc(h->cd[h->n]*sizeof(node_t),"adj");
+	h->ids=malloc(h->n*sizeof(uint64_t)+1);
+	#pragma omp parallel for schedule(dynamic,1024)
+	for (u=0;u<g->n;u++) {
+		offset_t j=h->cd[rank[u]];
+		nbriter it;
+		node_t v;
+		forneighbors(g,u,v,it)
+			h->adj[j++]=rank[v];
+		h->ids[rank[u]]=nodeid(g,u);
+	}
+	h->flags|=GRAPH_IDS|GRAPH_REORDERED;
+	//the nodes of g by increasing ID (g->byid, or 0..n-1 if g is not reordered) keep that order once renumbered
+	h->byid=malloc(h->n*sizeof(node_t)+1);
+	#pragma omp parallel for
+	for (u=0;u<g->n;u++)
+		h->byid[u]=rank[(g->byid!=NULL) ? g->byid[u] : u];
+	sortlists(h);
+
+	return h;
+}
@@ -0,0 +1,112 @@
+/*
+Info:
+Building the adjacency list directly from a text edge list, without the edge array of readedgelist.c.
+
+How it works:
+The text is mapped in memory (see readedgelist.c) and parsed three times by all the threads, each thread taking chunks of lines:
+- the first pass only finds the largest ID and the number of edges, the IDs are then compacted if they are sparse (see idmap.c),
+  so that cd can be allocated (and the 64-bit build chosen if needed);
+- the second pass counts the degrees in cd, which a parallel prefix sum turns into the start of each list;
+- the third pass scatters every edge into adj, cd[u] being the atomic cursor of the list of u.
+After the scatter cd[u] is the end of the list of u, shifting cd by one position gives back the starts.
+The peak memory is thus cd and adj only (plus the mapped text, which is page cache and can be evicted), instead of edges, cd and adj.
+Parsing is cheap compared to the memory traffic of the scatter, so reading the text three times costs little.
+
+Note:
+A graph given on the standard input is read in memory first, as it cannot be read several times.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <omp.h>
+
+#include "graph.h"
+#include "internal.h"
+
+//building the adjacency list from a text edge list, edge (s,t) is stored in the list of s and, if the graph is undirected, in the list of t
+adjlist* streamadjlist(char *input,int directed){
+	textfile f;
+	adjlist *g;
+	idmap *m;
+	int k,i;
+	unsigned long *ne,max,e=0;
+
+	openfile(input,&f);
+	k=nchunks(&f);
+	ne=malloc(k*sizeof(unsigned long));
+
+	//pass 1: largest ID and number of edges, then the mapping to dense IDs
+	max=scantext(&f,k,ne);
+	for (i=0;i<k;i++)
+		e+=ne[i];
+	m=mkidmap(&f,k,max,ne);
+	free(ne);
+
+	g=newadjlist(m->n,e,directed);
+	g->cd=galloc((g->n+1)*sizeof(offset_t),"cd");
+
+	//pass 2: degrees
+	#pragma omp parallel for schedule(dynamic,1)
+	for (i=0;i<k;i++) {
+		size_t p=chunkstart(&f,i,k),end=chunkstart(&f,i+1,k);
+		unsigned long s,t;
+		int ok;
+
+		while (p<end) {
+			p=parseline(f.buf,end,p,&s,&t,&ok);
+			if (!ok)
+				continue;
+			s=idmap_get(m,s);
+			t=idmap_get(m,t);
+			#pragma omp atomic
+			g->cd[s]++;
+			if (!directed) {
+				#pragma omp atomic
+				g->cd[t]++;
+			}
+		}
+	}
+
+	prefixsum(g->cd,g->cd,g->n);
+	g->adj=galloc(g->cd[g->n]*sizeof(node_t),"adj");
+
+	//pass 3: scatter, cd[u] is the next free position in the list of u
+	#pragma omp parallel for schedule(dynamic,1)
+	for (i=0;i<k;i++) {
+		size_t p=chunkstart(&f,i,k),end=chunkstart(&f,i+1,k);
+		unsigned long s,t;
+		offset_t q;
+		int ok;
+
+		while (p<end) {
+			p=parseline(f.buf,end,p,&s,&t,&ok);
+			if (!ok)
+				continue;
+			s=idmap_get(m,s);
+			t=idmap_get(m,t);
+			#pragma omp atomic capture
+			q=g->cd[s]++;
+			g->adj[q]=t;
+			if (!directed) {
+				#pragma omp atomic capture
+				q=g->cd[t]++;
+				g->adj[q]=s;
+			}
+		}
+	}
+	closefile(&f);
+
+	//cd[u] is now the end of the list of u, i.e. the start of the list of u+1
+	memmove(g->cd+1,g->cd,g->n*sizeof(offset_t));
+	g->cd[0]=0;
+
+	sortlists(g);
+
+	g->ids=idmap_ids(m);
+	if (g->ids!=NULL)
+		g->flags|=GRAPH_IDS;
+	free_idmap(m);
+
+	return g;
+}
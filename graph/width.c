@@ -0,0 +1,69 @@
+/*
+Info:
+Choosing between 32-bit and 64-bit node IDs and edge offsets at run time.
+The library is compiled twice (libgraph.a and libgraph64.a, see graph.h) and so is every tool ("bfs" and "bfs64").
+When the 32-bit build meets a graph that does not fit (more than 2^32 nodes, or 2e larger than 2^32-1), widen() replaces the process
+by the 64-bit build of the same program, called with the same arguments, so the tools never have to handle both widths.
+
+Note:
+The standard input cannot be read twice, so a graph given as "-" has to fit in 32 bits (or the 64-bit build has to be called directly).
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "graph.h"
+
+#define MAXARGS 4096
+
+//re-executing the 64-bit build of the program
+void widen(void){
+#ifdef GRAPH64
+	fprintf(stderr,"The graph does not fit in 64-bit node IDs and offsets\n");
+	exit(1);
+#else
+	char exe[PATH_MAX+8],*args[MAXARGS+1],*cmdline,*p;
+	ssize_t len,r,size=65536;
+	int fd,argc=0;
+
+	len=readlink("/proc/self/exe",exe,PATH_MAX);
+	if (len<0) {
+		fprintf(stderr,"The graph needs 64-bit node IDs or offsets, run the 64-bit build of this program\n");
+		exit(1);
+	}
+	exe[len]=0;
+	if (len>4 && strcmp(exe+len-4,".exe")==0)//triangle.exe -> triangle64.exe
+		strcpy(exe+len-4,"64.exe");
+	else
+		strcat(exe,"64");
+
+	//arguments of the current process, separated by '\0'
+	cmdline=malloc(size);
+	len=0;
+	fd=open("/proc/self/cmdline",O_RDONLY);
+	while (fd>=0 && (r=read(fd,cmdline+len,size-len))>0) {
+		len+=r;
+		if (len==size) {
+			size*=2;
+			cmdline=realloc(cmdline,size);
+		}
+	}
+	if (fd>=0)
+		close(fd);
+	for (p=cmdline;p<cmdline+len && argc<MAXARGS;p+=strlen(p)+1)
+		args[argc++]=p;
+	args[argc]=NULL;
+	if (argc>0)
+		args[0]=exe;
+
+	fprintf(stderr,"The graph needs 64-bit node IDs or offsets: running %s\n",exe);
+	fflush(stdout);
+	execv(exe,args);
+	fprintf(stderr,"Cannot run %s\n",exe);
+	exit(1);
+#endif
+}
@@ -0,0 +1,413 @@
+/*
+Info:
+Compressed edge lists (gzip, bzip2 and zstd) are decompressed in memory when they are opened, without a decompressed copy on the disk.
+The format is recognized from the first bytes of the file, whatever its name, so "-" (the standard input) can be compressed too.
+
+How it works:
+- gzip, bzip2 and zstd files whose frames do not all give their size: a decompression thread fills a ring of ZRING blocks of ZBLOCK bytes
+  while the calling thread appends every block to the text and parses it. The text is cut into chunks of about ZBLOCK bytes at line starts
+  and the largest ID and number of edges of each chunk are computed as soon as it is complete, so the first pass of the loaders (scantext)
+  overlaps with the decompression, which is the slowest step. The chunks then replace the one chunk per thread of readedgelist.c.
+  Concatenated streams (pigz, pbzip2, multi-frame zstd) are read one after the other.
+- zstd files of several frames that all give their decompressed size (e.g. "zstd -T0 --content-size" or pzstd): the frames are decompressed
+  in parallel, each one at its position in the text.
+The text is an anonymous mapping that grows with mremap, so that appending a block never copies the whole text.
+
+To compile:
+zlib and libbz2 are required, zstd is used when its header is installed (HAVE_ZSTD, see libs.mk).
+*/
+
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <omp.h>
+#include <zlib.h>
+#include <bzlib.h>
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+#include "graph.h"
+#include "internal.h"
+
+#define ZBLOCK 8388608 //size of the blocks given by the decompression thread, and of the chunks of the text
+#define ZRING 4 //number of blocks in flight between the decompression thread and the parser
+
+enum {Z_NONE,Z_GZIP,Z_BZIP2,Z_ZSTD};
+static const char *zname[]={"","gzip","bzip2","zstd"};
+
+static int zformat(const unsigned char *p,size_t len){
+	if (len>=2 && p[0]==0x1f && p[1]==0x8b)
+		return Z_GZIP;
+	if (len>=4 && p[0]=='B' && p[1]=='Z' && p[2]=='h' && p[3]>='1' && p[3]<='9')
+		return Z_BZIP2;
+	if (len>=4 && p[0]==0x28 && p[1]==0xb5 && p[2]==0x2f && p[3]==0xfd)
+		return Z_ZSTD;
+	return Z_NONE;
+}
+
+//streaming decompressor
+typedef struct {
+	int format;
+	z_stream gz;
+	bz_stream bz;
+#ifdef HAVE_ZSTD
+	ZSTD_DStream *zs;
+	ZSTD_inBuffer zin;
+#endif
+	const unsigned char *in;
+	size_t inlen;
+	int end;//1 when the input is exhausted
+} zstate;
+
+static void zfail(zstate *z){
+	fprintf(stderr,"Corrupted %s input\n",zname[z->format]);
+	exit(1);
+}
+
+static void zinit(zstate *z,int format,const unsigned char *in,size_t inlen){
+	memset(z,0,sizeof(zstate));
+	z->format=format;
+	z->in=in;
+	z->inlen=inlen;
+	switch (format) {
+		case Z_GZIP:
+			z->gz.next_in=(unsigned char*)in;
+			z->gz.avail_in=0;
+			if (inflateInit2(&z->gz,15+16)!=Z_OK)
+				zfail(z);
+			break;
+		case Z_BZIP2:
+			z->bz.next_in=(char*)in;
+			z->bz.avail_in=0;
+			if (BZ2_bzDecompressInit(&z->bz,0,0)!=BZ_OK)
+				zfail(z);
+			break;
+#ifdef HAVE_ZSTD
+		case Z_ZSTD:
+			z->zs=ZSTD_createDStream();
+			ZSTD_initDStream(z->zs);
+			z->zin.src=in;
+			z->zin.size=inlen;
+			z->zin.pos=0;
+			break;
+#endif
+	}
+}
+
+static void zend(zstate *z){
+	switch (z->format) {
+		case Z_GZIP:
+			inflateEnd(&z->gz);
+			break;
+		case Z_BZIP2:
+			BZ2_bzDecompressEnd(&z->bz);
+			break;
+#ifdef HAVE_ZSTD
+		case Z_ZSTD:
+			ZSTD_freeDStream(z->zs);
+			break;
+#endif
+	}
+}
+
+//next input bytes of zlib and bzip2, whose counters are 32-bit
+static inline unsigned refill(zstate *z,const unsigned char *next){
+	size_t left=z->inlen-(next-z->in);
+	return (left>UINT32_MAX) ? UINT32_MAX : left;
+}
+
+//decompressing up to n bytes in out, returns the number of bytes written (0 at the end of the input)
+static size_t zread(zstate *z,char *out,size_t n){
+	size_t len=0;
+	int r;
+
+	while (len<n && !z->end) {
+		switch (z->format) {
+			case Z_GZIP:
+				if (z->gz.avail_in==0)
+					z->gz.avail_in=refill(z,z->gz.next_in);
+				z->gz.next_out=(unsigned char*)out+len;
+				z->gz.avail_out=n-len;
+				r=inflate(&z->gz,Z_NO_FLUSH);
+				len=n-z->gz.avail_out;
+				if (r==Z_STREAM_END) {//another member may follow
+					if (refill(z,z->gz.next_in)==0 || zformat(z->gz.next_in,refill(z,z->gz.next_in))!=Z_GZIP)
+						z->end=1;
+					else
+						inflateReset(&z->gz);
+				}
+				else if ((r!=Z_OK && r!=Z_BUF_ERROR) || (r==Z_BUF_ERROR && refill(z,z->gz.next_in)==0))//corrupted or truncated
+					zfail(z);
+				break;
+			case Z_BZIP2:
+				if (z->bz.avail_in==0)
+					z->bz.avail_in=refill(z,(unsigned char*)z->bz.next_in);
+				z->bz.next_out=out+len;
+				z->bz.avail_out=n-len;
+				r=BZ2_bzDecompress(&z->bz);
+				len=n-z->bz.avail_out;
+				if (r==BZ_STREAM_END) {//another stream may follow
+					const unsigned char *next=(unsigned char*)z->bz.next_in;
+					unsigned avail=z->bz.avail_in;
+					if (refill(z,next)==0 || zformat(next,refill(z,next))!=Z_BZIP2)
+						z->end=1;
+					else {
+						BZ2_bzDecompressEnd(&z->bz);
+						memset(&z->bz,0,sizeof(bz_stream));
+						if (BZ2_bzDecompressInit(&z->bz,0,0)!=BZ_OK)
+							zfail(z);
+						z->bz.next_in=(char*)next;
+						z->bz.avail_in=avail;
+					}
+				}
+				else if (r!=BZ_OK || (z->bz.avail_in==0 && refill(z,(unsigned char*)z->bz.next_in)==0 && z->bz.avail_out>0))//corrupted or truncated
+					zfail(z);
+				break;
+#ifdef HAVE_ZSTD
+			case Z_ZSTD: {
+				ZSTD_outBuffer zout={out,n,len};
+				size_t ret=ZSTD_decompressStream(z->zs,&zout,&z->zin);
+				if (ZSTD_isError(ret))
+					zfail(z);
+				len=zout.pos;
+				if (z->zin.pos==z->zin.size && zout.pos<zout.size) {
+					if (ret!=0)//truncated frame
+						zfail(z);
+					z->end=1;
+				}
+				break;
+			}
+#endif
+		}
+	}
+	return len;
+}
+
+//ring of blocks between the decompression thread and the parser
+typedef struct {
+	zstate z;
+	char *block[ZRING];
+	size_t len[ZRING];
+	unsigned long produced,consumed;//number of blocks filled and appended to the text
+	int eof;
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+} zring;
+
+static void* producer(void *arg){
+	zring *r=arg;
+	size_t len;
+	int slot;
+
+	do {
+		pthread_mutex_lock(&r->lock);
+		while (r->produced-r->consumed==ZRING)
+			pthread_cond_wait(&r->cond,&r->lock);
+		slot=r->produced%ZRING;
+		pthread_mutex_unlock(&r->lock);
+
+		len=zread(&r->z,r->block[slot],ZBLOCK);
+
+		pthread_mutex_lock(&r->lock);
+		r->len[slot]=len;
+		if (len>0)
+			r->produced++;
+		else
+			r->eof=1;
+		pthread_cond_broadcast(&r->cond);
+		pthread_mutex_unlock(&r->lock);
+	} while (len>0);
+	return NULL;
+}
+
+//appending chunk [a,b) of the text to the chunks of f, with its largest ID and number of edges
+static void addchunk(textfile *f,size_t a,size_t b,int *cap){
+	unsigned long s,t,e=0;
+	int ok;
+
+	if (f->k+1>=*cap) {
+		*cap*=2;
+		f->cut=realloc(f->cut,*cap*sizeof(size_t));
+		f->ne=realloc(f->ne,*cap*sizeof(unsigned long));
+	}
+	while (a<b) {
+		a=parseline(f->buf,b,a,&s,&t,&ok);
+		if (!ok)
+			continue;
+		if (s>f->max)
+			f->max=s;
+		if (t>f->max)
+			f->max=t;
+		e++;
+	}
+	f->ne[f->k++]=e;
+	f->cut[f->k]=b;
+}
+
+//decompression thread and parser, the text of f is replaced by its decompressed content
+static void pipeline(textfile *f,int format,const unsigned char *in,size_t inlen){
+	zring r;
+	pthread_t th;
+	size_t size=4*(size_t)ZBLOCK,len=0,p;
+	char *buf=mmap(NULL,size,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+	int i,slot,cap=64;
+
+	zinit(&r.z,format,in,inlen);
+	for (i=0;i<ZRING;i++)
+		r.block[i]=malloc(ZBLOCK);
+	r.produced=r.consumed=0;
+	r.eof=0;
+	pthread_mutex_init(&r.lock,NULL);
+	pthread_cond_init(&r.cond,NULL);
+	pthread_create(&th,NULL,producer,&r);
+
+	f->k=0;
+	f->max=0;
+	f->cut=malloc(cap*sizeof(size_t));
+	f->ne=malloc(cap*sizeof(unsigned long));
+	f->cut[0]=0;
+	while (1) {
+		pthread_mutex_lock(&r.lock);
+		while (r.consumed==r.produced && !r.eof)
+			pthread_cond_wait(&r.cond,&r.lock);
+		if (r.consumed==r.produced) {
+			pthread_mutex_unlock(&r.lock);
+			break;
+		}
+		slot=r.consumed%ZRING;
+		pthread_mutex_unlock(&r.lock);
+
+		if (len+r.len[slot]>size) {
+			buf=mremap(buf,size,2*size,MREMAP_MAYMOVE);
+			if (buf==MAP_FAILED) {
+				fprintf(stderr,"Not enough memory for the decompressed text\n");
+				exit(1);
+			}
+			size*=2;
+		}
+		memcpy(buf+len,r.block[slot],r.len[slot]);
+		len+=r.len[slot];
+
+		pthread_mutex_lock(&r.lock);
+		r.consumed++;
+		pthread_cond_broadcast(&r.cond);
+		pthread_mutex_unlock(&r.lock);
+
+		//parsing the complete chunks while the next block is decompressed
+		f->buf=buf;
+		while (len-f->cut[f->k]>=ZBLOCK) {
+			p=f->cut[f->k]+ZBLOCK;
+			while (p>f->cut[f->k] && buf[p-1]!='\n')
+				p--;
+			if (p==f->cut[f->k])//no end of line in the chunk
+				p=nextline(buf,len,f->cut[f->k]+ZBLOCK);
+			if (p==len && buf[len-1]!='\n')//the last line may not be complete yet
+				break;
+			addchunk(f,f->cut[f->k],p,&cap);
+		}
+	}
+	pthread_join(th,NULL);
+	f->buf=buf;
+	if (len>f->cut[f->k] || f->k==0)
+		addchunk(f,f->cut[f->k],len,&cap);
+
+	//releasing the end of the mapping
+	if (len==0)
+		len=1;
+	f->buf=mremap(buf,size,len,0);
+	f->len=len;
+	f->mapped=1;
+
+	zend(&r.z);
+	for (i=0;i<ZRING;i++)
+		free(r.block[i]);
+	pthread_mutex_destroy(&r.lock);
+	pthread_cond_destroy(&r.cond);
+}
+
+#ifdef HAVE_ZSTD
+//decompressing the frames in parallel, returns 0 if the input has a single frame or some frame does not give its size
+static int zstdframes(textfile *f,const unsigned char *in,size_t inlen){
+	size_t *pos=NULL,*out=NULL,p=0,len=0;
+	unsigned long nf=0,i;
+	char *buf;
+	int ok=1;
+
+	while (p<inlen) {
+		size_t cs=ZSTD_findFrameCompressedSize(in+p,inlen-p);
+		unsigned long long ds=ZSTD_getFrameContentSize(in+p,inlen-p);
+		if (ZSTD_isError(cs) || ds==ZSTD_CONTENTSIZE_UNKNOWN || ds==ZSTD_CONTENTSIZE_ERROR) {
+			free(pos);
+			free(out);
+			return 0;
+		}
+		if (nf%64==0) {
+			pos=realloc(pos,(nf+65)*sizeof(size_t));
+			out=realloc(out,(nf+65)*sizeof(size_t));
+		}
+		pos[nf]=p;
+		out[nf++]=len;
+		p+=cs;
+		len+=ds;
+	}
+	pos[nf]=p;
+	out[nf]=len;
+	if (nf<2) {
+		free(pos);
+		free(out);
+		return 0;
+	}
+
+	buf=mmap(NULL,len+1,PROT_READ|PROT_WRITE,MAP_PRIVATE|MAP_ANONYMOUS,-1,0);
+	if (buf==MAP_FAILED) {
+		fprintf(stderr,"Not enough memory for the decompressed text\n");
+		exit(1);
+	}
+	#pragma omp parallel
+	{
+		ZSTD_DCtx *dctx=ZSTD_createDCtx();
+		#pragma omp for schedule(dynamic,1) reduction(&:ok)
+		for (i=0;i<nf;i++) {
+			size_t r=ZSTD_decompressDCtx(dctx,buf+out[i],out[i+1]-out[i],in+pos[i],pos[i+1]-pos[i]);
+			if (ZSTD_isError(r) || r!=out[i+1]-out[i])
+				ok=0;
+		}
+		ZSTD_freeDCtx(dctx);
+	}
+	if (!ok) {
+		fprintf(stderr,"Corrupted zstd input\n");
+		exit(1);
+	}
+
+	f->buf=buf;
+	f->len=len;
+	f->mapped=1;
+	free(pos);
+	free(out);
+	return 1;
+}
+#endif
+
+//decompressing the text of f if it is compressed, returns 1 if it was
+int decompress(textfile *f){
+	textfile in=*f;
+	int format=zformat((unsigned char*)f->buf,f->len);
+
+	if (format==Z_NONE)
+		return 0;
+#ifndef HAVE_ZSTD
+	if (format==Z_ZSTD) {
+		fprintf(stderr,"This program was compiled without zstd, decompress the graph with \"zstd -dc\" first\n");
+		exit(1);
+	}
+#else
+	if (format!=Z_ZSTD || !zstdframes(f,(unsigned char*)in.buf,in.len))
+#endif
+		pipeline(f,format,(unsigned char*)in.buf,in.len);
+	closefile(&in);
+	return 1;
+}
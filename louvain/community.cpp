@@ -18,6 +18,23 @@
 
 using namespace std;
 
+// decimal writing of x at p, returns the position after it
+static char *
+put_int(char *p, int x) {
+  char tmp[12];
+  int l=12;
+  unsigned int y=(x<0)?-(unsigned int)x:x;
+
+  do {
+    tmp[--l]='0'+y%10;
+    y/=10;
+  } while (y>0);
+  if (x<0)
+    tmp[--l]='-';
+  memcpy(p,tmp+l,12-l);
+  return p+12-l;
+}
+
 Community::Community(char * filename, char * filename_w, int type, int nbp, double minm) {
   g = Graph(filename, filename_w, type);
   size = g.nb_nodes;
@@ -198,8 +215,24 @@ Community::display_partition() {
     if (renumber[i]!=-1)
       renumber[i]=final++;
 
-  for (int i=0 ; i<size ; i++)
-    cout << i << " " << renumber[n2c[i]] << endl;
+  // the lines are formatted by hand in a large buffer written with one fwrite per block:
+  // endl flushes the stream at every line, which dominates the running time on large graphs
+  const int block=1<<16;
+  char *buf=(char*)malloc(block*24);
+  cout.flush();
+  for (int i=0 ; i<size ; i+=block) {
+    char *p=buf;
+    int end=(i+block<size)?i+block:size;
+    for (int j=i ; j<end ; j++) {
+      p=put_int(p,j);
+      *p++=' ';
+      p=put_int(p,renumber[n2c[j]]);
+      *p++='\n';
+    }
+    fwrite(buf,1,p-buf,stdout);
+  }
+  fflush(stdout);
+  free(buf);
 }
 
 
@@ -0,0 +1,237 @@
+/*
+Info:
+Feel free to use these lines as you wish. This program converts a text edge list into a binary CSR file.
+All the tools of the repository accept the CSR file in place of the edge list: they map it in memory instead of parsing the text and building the adjacency list again.
+
+To compile:
+"gcc mkcsr.c -O9 -o mkcsr -Igraph graph/libgraph.a -fopenmp -lz -lbz2" (after "make" in graph).
+
+To execute:
+"./mkcsr edgelist.txt graph.csr [directed] [compressed] [order=degree|rcm|gorder] [report]".
+"edgelist.txt" should contain the graph: one edge on each line (two unsigned long (nodes' ID)) separated by a space.
+"graph.csr" will contain the adjacency list.
+With "directed", edge (s,t) is only stored in the list of s (as needed by PageRank), otherwise the graph is undirected.
+With "compressed", the lists of neighbors are stored as varint-encoded gaps (see graph/compress.c): usually 2 to 4 times smaller, at a modest decoding cost.
+With "order=...", the nodes are renumbered to improve the locality of the accesses to per-node arrays (see graph/reorder.c), the tools still write the original IDs.
+"rcm" also makes the gaps, and thus the compressed file, smaller.
+With "report", the cache misses of a BFS and of a PageRank-like sweep over the neighbors are measured in the original order and in each order.
+They are read from the hardware counters (perf_event_open) when the system allows it, otherwise they are counted on a simulated 1MB 16-way cache.
+
+Note:
+If the graph is directed (and weighted) with selfloops and you want to make it undirected unweighted without selfloops, use the canonicalizer of the root directory (parallel, and it also works on files larger than the memory).
+./canon.exe net.txt net2.txt
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>//to estimate the runing time
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#include "graph.h"
+
+#define SIMSETS 1024 //simulated cache: 1024 sets of 16 lines of 64 bytes
+#define SIMWAYS 16
+
+static int perffd=-1;//hardware counter of cache misses, -1 if the cache is simulated
+static uint64_t simtag[SIMSETS][SIMWAYS],simtime[SIMSETS][SIMWAYS],simclock,simmisses;
+
+//memory access seen by the simulated cache (LRU)
+static inline void touch(const void *p){
+	uint64_t line=(uintptr_t)p>>6,set=line%SIMSETS;
+	int i,old=0;
+
+	if (perffd>=0)
+		return;
+	simclock++;
+	for (i=0;i<SIMWAYS;i++) {
+		if (simtag[set][i]==line+1) {
+			simtime[set][i]=simclock;
+			return;
+		}
+		if (simtime[set][i]<simtime[set][old])
+			old=i;
+	}
+	simmisses++;
+	simtag[set][old]=line+1;
+	simtime[set][old]=simclock;
+}
+
+static void perfopen(void){
+	struct perf_event_attr a;
+
+	memset(&a,0,sizeof(a));
+	a.type=PERF_TYPE_HARDWARE;
+	a.size=sizeof(a);
+	a.config=PERF_COUNT_HW_CACHE_MISSES;
+	a.disabled=1;
+	a.exclude_kernel=1;
+	a.exclude_hv=1;
+	perffd=syscall(__NR_perf_event_open,&a,0,-1,-1,0);
+}
+
+//cache misses of a BFS from node 0 and of a sweep reading x[v] for all the neighbors v of every node
+static double cachemisses(adjlist *g){
+	unsigned *dist=malloc(g->n*sizeof(unsigned));
+	node_t *list=malloc(g->n*sizeof(node_t)),v,w;
+	double *x=malloc(g->n*sizeof(double)),*y=malloc(g->n*sizeof(double)),s;
+	unsigned long i,l=1,u;
+	uint64_t count=0;
+	nbriter it;
+
+	for (i=0;i<g->n;i++) {
+		dist[i]=-1;
+		x[i]=1.;
+	}
+	memset(simtag,0,sizeof(simtag));
+	memset(simtime,0,sizeof(simtime));
+	simmisses=0;
+	if (perffd>=0) {
+		ioctl(perffd,PERF_EVENT_IOC_RESET,0);
+		ioctl(perffd,PERF_EVENT_IOC_ENABLE,0);
+	}
+
+	if (g->n>0) {
+		list[0]=0;
+		dist[0]=0;
+	}
+	for (i=0;i<l;i++) {
+		v=list[i];
+		forneighbors(g,v,w,it) {
+			touch(dist+w);
+			if (dist[w]==(unsigned)-1) {
+				list[l++]=w;
+				dist[w]=dist[v]+1;
+			}
+		}
+	}
+	for (u=0;u<g->n;u++) {
+		s=0;
+		forneighbors(g,u,v,it) {
+			touch(x+v);
+			s+=x[v];
+		}
+		y[u]=s;
+	}
+
+	if (perffd>=0) {
+		ioctl(perffd,PERF_EVENT_IOC_DISABLE,0);
+		if (read(perffd,&count,sizeof(count))!=sizeof(count))
+			count=0;
+	}
+	else
+		count=simmisses;
+
+	free(dist);
+	free(list);
+	free(x);
+	free(y);
+	return (g->e>0) ? (double)count/g->e : 0.;
+}
+
+//cache misses in the original order and in each order
+static void report(adjlist *g){
+	const char *names[]={"degree","rcm","gorder"};
+	double m0,m;
+	adjlist *h;
+	node_t *rank;
+	time_t t1,t2;
+	int o;
+
+	perfopen();
+	printf("Cache misses per edge (%s) of a BFS and a sweep over the neighbors:\n",(perffd>=0) ? "hardware counter" : "simulated 1MB 16-way cache");
+	m0=cachemisses(g);
+	printf("original: %.3f\n",m0);
+	for (o=ORDER_DEGREE;o<=ORDER_GORDER;o++) {
+		t1=time(NULL);
+		rank=mkorder(g,o);
+		h=permute_adjlist(g,rank);
+		t2=time(NULL);
+		m=cachemisses(h);
+		printf("%s: %.3f (%+.1f%%, computed in %lds)\n",names[o-1],m,(m0>0) ? 100.*(m-m0)/m0 : 0.,(long)(t2-t1));
+		free(rank);
+		free_adjlist(h);
+	}
+	if (perffd>=0)
+		close(perffd);
+}
+
+int main(int argc,char** argv){
+	adjlist* g;
+	int directed=0,compressed=0,order=0,rep=0,i;
+	node_t *rank;
+	adjlist *h;
+	char *ordername=NULL;
+	time_t t1,t2;
+
+	if (argc<3) {
+		printf("Usage: %s edgelist.txt graph.csr [directed] [compressed] [order=degree|rcm|gorder] [report]\n",argv[0]);
+		return 1;
+	}
+	for (i=3;i<argc;i++) {
+		if (strcmp(argv[i],"directed")==0)
+			directed=1;
+		else if (strcmp(argv[i],"compressed")==0)
+			compressed=1;
+		else if (strncmp(argv[i],"order=",6)==0) {
+			ordername=argv[i]+6;
+			if (strcmp(ordername,"degree")==0)
+				order=ORDER_DEGREE;
+			else if (strcmp(ordername,"rcm")==0)
+				order=ORDER_RCM;
+			else if (strcmp(ordername,"gorder")==0)
+				order=ORDER_GORDER;
+			else {
+				printf("Unknown order %s\n",ordername);
+				return 1;
+			}
+		}
+		else if (strcmp(argv[i],"report")==0)
+			rep=1;
+		else {
+			printf("Unknown option %s\n",argv[i]);
+			return 1;
+		}
+	}
+
+	t1=time(NULL);
+
+	printf("Reading edgelist from file %s and building the adjacency list\n",argv[1]);
+	g=streamadjlist(argv[1],directed);
+
+	printf("Number of nodes: %lu\n",g->n);
+	printf("Number of edges: %lu\n",g->e);
+
+	if (rep)
+		report(g);
+
+	if (order) {
+		printf("Renumbering the nodes (%s order)\n",ordername);
+		rank=mkorder(g,order);
+		h=permute_adjlist(g,rank);
+		free(rank);
+		free_adjlist(g);
+		g=h;
+	}
+
+	if (compressed) {
+		printf("Compressing the adjacency list\n");
+		printf("Size of the lists of neighbors: %lu bytes",(unsigned long)adjbytes(g));
+		compress_adjlist(g);
+		printf(" -> %lu bytes\n",(unsigned long)adjbytes(g));
+	}
+
+	printf("Writting to file %s\n",argv[2]);
+	writecsr(g,argv[2]);
+
+	free_adjlist(g);
+
+	t2=time(NULL);
+
+	printf("- Overall time = %ldh%ldm%lds\n",(t2-t1)/3600,((t2-t1)%3600)/60,((t2-t1)%60));
+
+	return 0;
+}